@@ -39,6 +39,15 @@ def peak_dbfs(y):
     if pk<=1e-12: return -120.0
     return 20.0*math.log10(pk)
 
+def probe_features(y, sr):
+    # juce_probe's own numbers (sidecar features.global) via the _ma_probe_native
+    # extension (plugins/juce_probe, -DMA_PROBE_BUILD_PYTHON=ON); None if not importable.
+    try:
+        import _ma_probe_native
+    except ImportError:
+        return None
+    return _ma_probe_native.analyse(y, float(sr), channels_last=True)["global"]
+
 def main():
     ap=argparse.ArgumentParser()
     ap.add_argument("path")
@@ -56,6 +65,9 @@ def main():
     except Exception as e:
         print(f"loudness_lufs_r128: ERROR ({e})")
         sys.exit(2)
+    probe=probe_features(y, sr)
+    if probe is not None:
+        print(f"probe_integrated_lufs: {probe['integrated_lufs']:.2f}  probe_peak_db: {probe['peak_db']:.2f}  probe_true_peak_dbtp: {probe['true_peak_dbtp']:.2f}")
 
 if __name__=="__main__":
     main()
@@ -0,0 +1,131 @@
+# Script mode: cmake -DTOKENS_JSON=<ma_tokens.json> -DOUTPUT=<MaTokens.h> -P GenerateDesignTokens.cmake
+#
+# Turns the exported MAStyle palette into constexpr packed ARGB colours and
+# integer spacing/radius constants, so no plugin parses colour strings or keeps
+# them around at runtime. Colours may be "#RRGGBB", "#RRGGBBAA" or
+# "rgba(r,g,b,a)" with a in 0..1.
+
+cmake_minimum_required(VERSION 3.21)
+
+if(NOT TOKENS_JSON OR NOT OUTPUT)
+    message(FATAL_ERROR "GenerateDesignTokens: TOKENS_JSON and OUTPUT are required")
+endif()
+
+file(READ "${TOKENS_JSON}" tokens)
+
+# "0.12" -> 31 (rounded 0..255), without floating point (unavailable in math()).
+function(_ma_unit_to_byte value out)
+    if(NOT value MATCHES "^([01])(\\.([0-9]*))?$")
+        message(FATAL_ERROR "GenerateDesignTokens: alpha '${value}' is not in 0..1")
+    endif()
+    set(whole "${CMAKE_MATCH_1}")
+    string(SUBSTRING "${CMAKE_MATCH_3}000" 0 3 milli)
+    string(REGEX REPLACE "^0+([0-9])" "\\1" milli "${milli}")
+    math(EXPR byte "((${whole} * 1000 + ${milli}) * 255 + 500) / 1000")
+    if(byte GREATER 255)
+        set(byte 255)
+    endif()
+    set(${out} ${byte} PARENT_SCOPE)
+endfunction()
+
+function(_ma_colour_to_argb name text out)
+    string(STRIP "${text}" text)
+    if(text MATCHES "^#([0-9A-Fa-f][0-9A-Fa-f])([0-9A-Fa-f][0-9A-Fa-f])([0-9A-Fa-f][0-9A-Fa-f])([0-9A-Fa-f][0-9A-Fa-f])?$")
+        math(EXPR r "0x${CMAKE_MATCH_1}")
+        math(EXPR g "0x${CMAKE_MATCH_2}")
+        math(EXPR b "0x${CMAKE_MATCH_3}")
+        if(CMAKE_MATCH_4)
+            math(EXPR a "0x${CMAKE_MATCH_4}")
+        else()
+            set(a 255)
+        endif()
+    elseif(text MATCHES "^rgba?\\( *([0-9]+) *, *([0-9]+) *, *([0-9]+) *(, *([0-9.]+) *)?\\)$")
+        set(r ${CMAKE_MATCH_1})
+        set(g ${CMAKE_MATCH_2})
+        set(b ${CMAKE_MATCH_3})
+        if(CMAKE_MATCH_5)
+            _ma_unit_to_byte("${CMAKE_MATCH_5}" a)
+        else()
+            set(a 255)
+        endif()
+    else()
+        message(FATAL_ERROR "GenerateDesignTokens: colour '${name}' has unsupported value '${text}'")
+    endif()
+
+    foreach(c IN ITEMS ${r} ${g} ${b})
+        if(c GREATER 255)
+            message(FATAL_ERROR "GenerateDesignTokens: colour '${name}' component ${c} > 255")
+        endif()
+    endforeach()
+
+    math(EXPR argb "(${a} << 24) | (${r} << 16) | (${g} << 8) | ${b}" OUTPUT_FORMAT HEXADECIMAL)
+    string(TOUPPER "${argb}" argb)
+    string(REPLACE "0X" "" argb "${argb}")
+    string(LENGTH "${argb}" len)
+    while(len LESS 8)
+        string(PREPEND argb "0")
+        math(EXPR len "${len} + 1")
+    endwhile()
+    set(${out} "0x${argb}u" PARENT_SCOPE)
+endfunction()
+
+# Emits one constexpr per key of the JSON object at `section`.
+function(_ma_emit_section section kind out)
+    string(JSON count LENGTH "${tokens}" ${section})
+    set(body "")
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(i RANGE ${last})
+            string(JSON key MEMBER "${tokens}" ${section} ${i})
+            string(JSON value GET "${tokens}" ${section} ${key})
+            if(kind STREQUAL "colour")
+                _ma_colour_to_argb("${key}" "${value}" literal)
+                string(APPEND body "inline constexpr std::uint32_t ${key} = ${literal}; // ${value}\n")
+            else()
+                if(NOT value MATCHES "^-?[0-9]+$")
+                    message(FATAL_ERROR "GenerateDesignTokens: ${section}.${key} = '${value}' is not an integer")
+                endif()
+                string(APPEND body "inline constexpr int ${key} = ${value};\n")
+            endif()
+        endforeach()
+    endif()
+    set(${out} "${body}" PARENT_SCOPE)
+endfunction()
+
+_ma_emit_section(colors colour colours)
+_ma_emit_section(spacing int spacing)
+_ma_emit_section(radius int radius)
+
+get_filename_component(source_name "${TOKENS_JSON}" NAME)
+set(header "// Generated by plugins/common/cmake/GenerateDesignTokens.cmake from ${source_name}. Do not edit.
+
+#pragma once
+
+#include <cstdint>
+
+namespace ma::tokens
+{
+// Packed 0xAARRGGBB, the layout juce::Colour (uint32) takes.
+namespace colour
+{
+${colours}} // namespace colour
+
+// Points.
+namespace spacing
+{
+${spacing}} // namespace spacing
+
+namespace radius
+{
+${radius}} // namespace radius
+} // namespace ma::tokens
+")
+
+# Only touch the file when the content changes so dependents don't rebuild.
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" existing)
+    if(existing STREQUAL header)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${header}")
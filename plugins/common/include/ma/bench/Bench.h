@@ -0,0 +1,103 @@
+#pragma once
+
+// Minimal benchmark harness shared by the plugins' *_bench console targets.
+// Each case is timed with steady_clock until `minSeconds` have elapsed (after
+// one warm-up call) and reported as one JSON object per line on stdout, so CI
+// can diff runs without a parser dependency. Header-only and JUCE-free.
+
+#include <ma/text/NumberFormat.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ma::bench
+{
+struct Result
+{
+    long long iterations{0};
+    double nsPerIteration{0.0};
+};
+
+// Calls fn() repeatedly; fn returns nothing. Doubles the batch size until the
+// batch takes long enough to time reliably.
+template <typename Fn>
+Result measure(Fn&& fn, double minSeconds = 0.2)
+{
+    using Clock = std::chrono::steady_clock;
+    fn(); // warm caches, fault in lazily mapped pages
+
+    Result r;
+    long long batch = 1;
+    double elapsed = 0.0;
+    while (elapsed < minSeconds)
+    {
+        const auto start = Clock::now();
+        for (long long i = 0; i < batch; ++i)
+            fn();
+        elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+        r.iterations += batch;
+        if (batch < (1LL << 20))
+            batch *= 2;
+    }
+    r.nsPerIteration = elapsed * 1.0e9 / (double) r.iterations;
+    return r;
+}
+
+// Times a single call (for cases that are too long or stateful to repeat).
+template <typename Fn>
+Result measureOnce(Fn&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    fn();
+    Result r;
+    r.iterations = 1;
+    r.nsPerIteration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return r;
+}
+
+// One JSON line: {"case":..., <params>, "iterations":..., "ns_per_iter":..., <metrics>}.
+class Reporter
+{
+public:
+    using Fields = std::vector<std::pair<std::string, double>>;
+
+    explicit Reporter(std::string suiteName, std::FILE* out = stdout)
+        : suite(std::move(suiteName)), stream(out) {}
+
+    void report(const std::string& caseName, const Fields& params, const Result& r,
+                const Fields& metrics = {}) const
+    {
+        std::string line = "{\"suite\":\"" + suite + "\",\"case\":\"" + caseName + "\"";
+        for (const auto& [key, value] : params)
+            appendField(line, key, value, ma::text::formatGeneral, 17);
+        appendField(line, "iterations", (double) r.iterations, ma::text::formatGeneral, 17);
+        appendField(line, "ns_per_iter", r.nsPerIteration, ma::text::formatFixed, 3);
+        for (const auto& [key, value] : metrics)
+            appendField(line, key, value, ma::text::formatGeneral, 6);
+        line += "}\n";
+        std::fputs(line.c_str(), stream);
+        std::fflush(stream);
+    }
+
+private:
+    // Numbers via ma::text, not printf, so the host locale cannot turn "." into ",".
+    template <typename Format>
+    static void appendField(std::string& line, const std::string& key, double value, Format format, int precision)
+    {
+        line += ",\"" + key + "\":";
+        char buffer[ma::text::kNumberBufferBytes];
+        if (std::isfinite(value))
+            line.append(buffer, format(buffer, sizeof(buffer), value, precision));
+        else
+            line += "null";
+    }
+
+    std::string suite;
+    std::FILE* stream;
+};
+} // namespace ma::bench
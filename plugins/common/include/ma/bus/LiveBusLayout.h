@@ -0,0 +1,178 @@
+#pragma once
+
+// Binary layout of the probe's shared-memory live feature bus. Each probe
+// instance owns one segment ("/ma_probe_<pid>_<slot>"): a header with the
+// session aggregates, then a ring of fixed-size timeline points. A registry
+// segment ("/ma_probe_registry") lists the active instances by track/session id.
+// Everything is little-endian, naturally aligned and fixed-size so Python
+// (mmap + struct) or Swift readers can map the segments and read in place; the
+// offsets below are part of the format and checked at compile time.
+//
+// Concurrency is one writer per segment and any number of readers, no locks:
+//   - header aggregates and registry slots are seqlock-protected: the writer
+//     makes `seq` odd, writes, then makes it even again; a reader copies the
+//     fields and retries when `seq` was odd or changed in between.
+//   - ring slot i holds point index (pointsWritten - 1 - k) and carries a `stamp`
+//     (index + 1, or 0 while it is rewritten); a copy is valid when the stamp
+//     read before and after it equals the expected index + 1.
+// Header-only and JUCE-free.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ma::bus
+{
+inline constexpr char kRegistryName[] = "/ma_probe_registry";
+inline constexpr char kSegmentPrefix[] = "/ma_probe_"; // + "<pid>_<slot>"
+inline constexpr char kSegmentMagic[8] = { 'M', 'A', 'P', 'R', 'B', 'U', 'S', '1' };
+inline constexpr char kRegistryMagic[8] = { 'M', 'A', 'P', 'R', 'R', 'E', 'G', '1' };
+inline constexpr uint32_t kVersion = 1;
+
+inline constexpr int kIdBytes = 64;          // NUL-terminated UTF-8, truncated
+inline constexpr int kSegmentNameBytes = 32; // macOS caps shm names at 31 chars
+inline constexpr int kNumOctaveBands = 10;
+inline constexpr uint32_t kRingCapacity = 1024; // ~4 min at the 0.25 s timeline spacing
+inline constexpr int kRegistrySlots = 64;
+
+enum SegmentFlags : uint32_t
+{
+    kFlagSpectral = 1u << 0, // spectral/tempo fields are live (NaN otherwise)
+};
+
+enum SlotState : uint32_t
+{
+    kSlotFree = 0,
+    kSlotClaiming = 1, // being (re)initialised; pid and heartbeat stamped at the claim
+    kSlotActive = 2,
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == 4,
+              "bus counters must be plain 32-bit words in shared memory");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(std::atomic<uint64_t>) == 8,
+              "bus counters must be plain 64-bit words in shared memory");
+
+// Session aggregates; mirrors the sidecar's features.global.
+struct LiveAggregates
+{
+    double durationSec;
+    double integratedRmsDb;
+    double peakDb;
+    double crestDb;
+    double integratedLufs;
+    double maxMomentaryLufs;
+    double maxShortTermLufs;
+    double truePeakDbtp;
+    double bpm;
+    double bpmConfidence;
+    double onsetRateHz;
+    int64_t onsetCount;
+};
+
+struct SegmentHeader
+{
+    char magic[8];                      // kSegmentMagic
+    uint32_t version;                   // kVersion
+    uint32_t headerBytes;               // offset of ring slot 0
+    uint32_t pointBytes;                // stride of one ring slot
+    uint32_t ringCapacity;
+    uint32_t pid;
+    uint32_t reserved0;
+    std::atomic<uint64_t> pointsWritten; // total points published; not under seq
+    std::atomic<uint64_t> heartbeatNs;   // unix time of the last writer pass; not under seq
+    std::atomic<uint32_t> seq;           // seqlock over the fields below
+    uint32_t flags;                      // SegmentFlags
+    uint64_t generation;                 // bumped when the session restarts (prepare/reset)
+    double sampleRate;
+    LiveAggregates aggregates;
+    char trackId[kIdBytes];
+    char sessionId[kIdBytes];
+    uint8_t reserved1[48];
+};
+
+struct LivePoint
+{
+    std::atomic<uint64_t> stamp; // absolute point index + 1; 0 while being written
+    double timeSec;              // seconds since the session (generation) started
+    float rmsDb;
+    float peakDb;
+    float momentaryLufs;
+    float shortTermLufs;
+    float spectralCentroidHz;
+    float spectralRolloffHz;
+    float spectralFlux;
+    float tempoBpm;
+    float octaveBandDb[kNumOctaveBands];
+    uint32_t reserved[2];
+};
+
+struct RegistryHeader
+{
+    char magic[8];     // kRegistryMagic
+    uint32_t version;  // kVersion
+    uint32_t headerBytes;
+    uint32_t slotBytes;
+    uint32_t numSlots; // kRegistrySlots
+    uint8_t reserved[40];
+};
+
+struct RegistrySlot
+{
+    std::atomic<uint32_t> state;       // SlotState; claimed with a compare-exchange
+    std::atomic<uint32_t> seq;         // seqlock over pid..sessionId
+    std::atomic<uint64_t> heartbeatNs; // copy of the segment heartbeat, for listings; the claim time while claiming
+    uint32_t pid;
+    uint32_t reserved0;
+    char segmentName[kSegmentNameBytes];
+    char trackId[kIdBytes];
+    char sessionId[kIdBytes];
+};
+
+static_assert(offsetof(SegmentHeader, pointsWritten) == 32);
+static_assert(offsetof(SegmentHeader, seq) == 48);
+static_assert(offsetof(SegmentHeader, generation) == 56);
+static_assert(offsetof(SegmentHeader, aggregates) == 72);
+static_assert(offsetof(SegmentHeader, trackId) == 168);
+static_assert(offsetof(SegmentHeader, sessionId) == 232);
+static_assert(sizeof(SegmentHeader) == 344);
+static_assert(offsetof(LivePoint, octaveBandDb) == 48);
+static_assert(sizeof(LivePoint) == 96);
+static_assert(sizeof(RegistryHeader) == 64);
+static_assert(offsetof(RegistrySlot, segmentName) == 24);
+static_assert(sizeof(RegistrySlot) == 184);
+
+// Ring slots start on a cache line after the header.
+inline constexpr size_t kSegmentHeaderBytes = 384;
+inline constexpr size_t kSegmentBytes = kSegmentHeaderBytes + (size_t) kRingCapacity * sizeof(LivePoint);
+inline constexpr size_t kRegistryBytes = sizeof(RegistryHeader) + (size_t) kRegistrySlots * sizeof(RegistrySlot);
+
+// Writer side of the seqlock; payload stores go between begin and end.
+inline void beginWrite(std::atomic<uint32_t>& seq) noexcept
+{
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void endWrite(std::atomic<uint32_t>& seq) noexcept
+{
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Reader side: copies with `copy()` until it gets an untorn snapshot, at most
+// `maxAttempts` times. Returns false if the writer kept it busy.
+template <typename CopyFn>
+bool readConsistent(const std::atomic<uint32_t>& seq, CopyFn&& copy, int maxAttempts = 64) noexcept
+{
+    for (int attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        const auto before = seq.load(std::memory_order_acquire);
+        if ((before & 1u) != 0)
+            continue;
+        copy();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
+} // namespace ma::bus
@@ -0,0 +1,230 @@
+#pragma once
+
+// Single-pass sum-of-squares / peak / DC kernel shared by the JUCE plugins.
+// Header-only and JUCE-free so offline tools can reuse the exact same math.
+//
+// Paths: AVX2 (runtime-detected on GCC/Clang x86, compile-time elsewhere),
+// SSE2 (x86-64 baseline), NEON (AArch64), scalar fallback. Squares and sums are
+// accumulated in double lanes so results stay close to the old scalar loop.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+ #define MA_BLOCKSTATS_SSE2 1
+ #include <emmintrin.h>
+ #if defined(__AVX2__)
+  #define MA_BLOCKSTATS_AVX2 1
+  #include <immintrin.h>
+ #elif (defined(__GNUC__) || defined(__clang__)) && ! defined(MA_BLOCKSTATS_NO_DISPATCH)
+  #define MA_BLOCKSTATS_AVX2 1
+  #define MA_BLOCKSTATS_AVX2_DISPATCH 1
+  #include <immintrin.h>
+ #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+ #define MA_BLOCKSTATS_NEON 1
+ #include <arm_neon.h>
+#endif
+
+namespace ma::dsp
+{
+struct BlockStats
+{
+    double sumSquares{0.0};
+    double sum{0.0}; // only filled when DC measurement is requested
+    float peak{0.0f};
+    int64_t samples{0};
+
+    double meanSquare() const noexcept { return samples > 0 ? sumSquares / (double) samples : 0.0; }
+    double rms() const noexcept { return std::sqrt(meanSquare()); }
+    double dcOffset() const noexcept { return samples > 0 ? sum / (double) samples : 0.0; }
+
+    void merge(const BlockStats& other) noexcept
+    {
+        sumSquares += other.sumSquares;
+        sum += other.sum;
+        peak = std::max(peak, other.peak);
+        samples += other.samples;
+    }
+};
+
+namespace detail
+{
+inline void accumulateScalar(const float* data, int begin, int end, bool measureDc,
+                             double& sumSquares, double& sum, float& peak) noexcept
+{
+    for (int i = begin; i < end; ++i)
+    {
+        const double s = (double) data[i];
+        sumSquares += s * s;
+        if (measureDc)
+            sum += s;
+        peak = std::max(peak, std::abs(data[i]));
+    }
+}
+
+#if MA_BLOCKSTATS_SSE2
+inline int accumulateSse2(const float* data, int numSamples, bool measureDc,
+                          double& sumSquares, double& sum, float& peak) noexcept
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vPeak = _mm_setzero_ps();
+    __m128d vSq0 = _mm_setzero_pd(), vSq1 = _mm_setzero_pd();
+    __m128d vSum0 = _mm_setzero_pd(), vSum1 = _mm_setzero_pd();
+
+    const int vectorEnd = numSamples & ~3;
+    for (int i = 0; i < vectorEnd; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(data + i);
+        vPeak = _mm_max_ps(vPeak, _mm_and_ps(x, absMask));
+        const __m128d lo = _mm_cvtps_pd(x);
+        const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+        vSq0 = _mm_add_pd(vSq0, _mm_mul_pd(lo, lo));
+        vSq1 = _mm_add_pd(vSq1, _mm_mul_pd(hi, hi));
+        if (measureDc)
+        {
+            vSum0 = _mm_add_pd(vSum0, lo);
+            vSum1 = _mm_add_pd(vSum1, hi);
+        }
+    }
+
+    alignas(16) double sq[2], sm[2];
+    alignas(16) float pk[4];
+    _mm_store_pd(sq, _mm_add_pd(vSq0, vSq1));
+    _mm_store_pd(sm, _mm_add_pd(vSum0, vSum1));
+    _mm_store_ps(pk, vPeak);
+    sumSquares += sq[0] + sq[1];
+    sum += sm[0] + sm[1];
+    peak = std::max({peak, pk[0], pk[1], pk[2], pk[3]});
+    return vectorEnd;
+}
+#endif
+
+#if MA_BLOCKSTATS_AVX2
+ #if MA_BLOCKSTATS_AVX2_DISPATCH
+  #define MA_BLOCKSTATS_AVX2_TARGET __attribute__((target("avx2")))
+ #else
+  #define MA_BLOCKSTATS_AVX2_TARGET
+ #endif
+MA_BLOCKSTATS_AVX2_TARGET
+inline int accumulateAvx2(const float* data, int numSamples, bool measureDc,
+                          double& sumSquares, double& sum, float& peak) noexcept
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vPeak = _mm256_setzero_ps();
+    __m256d vSq0 = _mm256_setzero_pd(), vSq1 = _mm256_setzero_pd();
+    __m256d vSum0 = _mm256_setzero_pd(), vSum1 = _mm256_setzero_pd();
+
+    const int vectorEnd = numSamples & ~7;
+    for (int i = 0; i < vectorEnd; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(data + i);
+        vPeak = _mm256_max_ps(vPeak, _mm256_and_ps(x, absMask));
+        const __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+        const __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+        vSq0 = _mm256_add_pd(vSq0, _mm256_mul_pd(lo, lo));
+        vSq1 = _mm256_add_pd(vSq1, _mm256_mul_pd(hi, hi));
+        if (measureDc)
+        {
+            vSum0 = _mm256_add_pd(vSum0, lo);
+            vSum1 = _mm256_add_pd(vSum1, hi);
+        }
+    }
+
+    alignas(32) double sq[4], sm[4];
+    alignas(32) float pk[8];
+    _mm256_store_pd(sq, _mm256_add_pd(vSq0, vSq1));
+    _mm256_store_pd(sm, _mm256_add_pd(vSum0, vSum1));
+    _mm256_store_ps(pk, vPeak);
+    sumSquares += (sq[0] + sq[1]) + (sq[2] + sq[3]);
+    sum += (sm[0] + sm[1]) + (sm[2] + sm[3]);
+    peak = std::max({peak, pk[0], pk[1], pk[2], pk[3], pk[4], pk[5], pk[6], pk[7]});
+    return vectorEnd;
+}
+
+inline bool cpuHasAvx2() noexcept
+{
+ #if MA_BLOCKSTATS_AVX2_DISPATCH
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+ #else
+    return true;
+ #endif
+}
+#endif
+
+#if MA_BLOCKSTATS_NEON
+inline int accumulateNeon(const float* data, int numSamples, bool measureDc,
+                          double& sumSquares, double& sum, float& peak) noexcept
+{
+    float32x4_t vPeak = vdupq_n_f32(0.0f);
+    float64x2_t vSq0 = vdupq_n_f64(0.0), vSq1 = vdupq_n_f64(0.0);
+    float64x2_t vSum0 = vdupq_n_f64(0.0), vSum1 = vdupq_n_f64(0.0);
+
+    const int vectorEnd = numSamples & ~3;
+    for (int i = 0; i < vectorEnd; i += 4)
+    {
+        const float32x4_t x = vld1q_f32(data + i);
+        vPeak = vmaxq_f32(vPeak, vabsq_f32(x));
+        const float64x2_t lo = vcvt_f64_f32(vget_low_f32(x));
+        const float64x2_t hi = vcvt_high_f64_f32(x);
+        vSq0 = vaddq_f64(vSq0, vmulq_f64(lo, lo));
+        vSq1 = vaddq_f64(vSq1, vmulq_f64(hi, hi));
+        if (measureDc)
+        {
+            vSum0 = vaddq_f64(vSum0, lo);
+            vSum1 = vaddq_f64(vSum1, hi);
+        }
+    }
+
+    sumSquares += vaddvq_f64(vaddq_f64(vSq0, vSq1));
+    sum += vaddvq_f64(vaddq_f64(vSum0, vSum1));
+    peak = std::max(peak, vmaxvq_f32(vPeak));
+    return vectorEnd;
+}
+#endif
+} // namespace detail
+
+// Accumulates one channel into `stats`. Real-time safe: no allocation, no locks.
+inline void accumulateChannel(const float* data, int numSamples, BlockStats& stats,
+                              bool measureDc = false) noexcept
+{
+    if (data == nullptr || numSamples <= 0)
+        return;
+
+    double sumSquares = 0.0, sum = 0.0;
+    float peak = 0.0f;
+    int done = 0;
+
+#if MA_BLOCKSTATS_AVX2
+    if (detail::cpuHasAvx2())
+        done = detail::accumulateAvx2(data, numSamples, measureDc, sumSquares, sum, peak);
+    else
+#endif
+    {
+#if MA_BLOCKSTATS_SSE2
+        done = detail::accumulateSse2(data, numSamples, measureDc, sumSquares, sum, peak);
+#elif MA_BLOCKSTATS_NEON
+        done = detail::accumulateNeon(data, numSamples, measureDc, sumSquares, sum, peak);
+#endif
+    }
+
+    detail::accumulateScalar(data, done, numSamples, measureDc, sumSquares, sum, peak);
+
+    stats.sumSquares += sumSquares;
+    stats.sum += sum;
+    stats.peak = std::max(stats.peak, peak);
+    stats.samples += numSamples;
+}
+
+// Accumulates every channel of a planar block; `samples` counts numChannels * numSamples.
+inline BlockStats computeBlockStats(const float* const* channels, int numChannels, int numSamples,
+                                    bool measureDc = false) noexcept
+{
+    BlockStats stats;
+    for (int ch = 0; ch < numChannels; ++ch)
+        accumulateChannel(channels[ch], numSamples, stats, measureDc);
+    return stats;
+}
+} // namespace ma::dsp
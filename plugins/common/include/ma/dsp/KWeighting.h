@@ -0,0 +1,177 @@
+#pragma once
+
+// ITU-R BS.1770-4 K-weighting (high-shelf pre-filter + RLB high-pass) for any
+// sample rate, run as a bank of biquads with channels laid out in SIMD lanes.
+// The per-sample loop walks a fixed-width group of lanes so the compiler can
+// vectorise across channels (SSE/AVX/NEON) instead of across time, which the
+// IIR recursion forbids. Header-only and JUCE-free.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace ma::dsp
+{
+struct BiquadCoefficients
+{
+    double b0{1.0}, b1{0.0}, b2{0.0}, a1{0.0}, a2{0.0};
+};
+
+struct KWeightingCoefficients
+{
+    BiquadCoefficients shelf;
+    BiquadCoefficients highpass;
+
+    // Bilinear re-derivation of the 48 kHz reference filters (same constants as libebur128).
+    static KWeightingCoefficients forSampleRate(double sampleRate) noexcept
+    {
+        constexpr double pi = 3.14159265358979323846;
+        KWeightingCoefficients c;
+
+        {
+            const double f0 = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            c.shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            c.shelf.b1 = 2.0 * (k * k - vh) / a0;
+            c.shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            c.shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            c.shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        {
+            const double f0 = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            c.highpass.b0 = 1.0;
+            c.highpass.b1 = -2.0;
+            c.highpass.b2 = 1.0;
+            c.highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+            c.highpass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+        return c;
+    }
+};
+
+// Mean-square accumulator for BS.1770 loudness: each block returns
+// sum over samples of sum_ch(G_ch * y_ch^2), K-weighted.
+class KWeightingFilterBank
+{
+public:
+    static constexpr int kLanes = 4;
+    static constexpr int kMaxChannels = 16;
+
+    // Recomputes coefficients and clears state; no allocation.
+    void prepare(double sampleRate, int channels) noexcept
+    {
+        coeffs = KWeightingCoefficients::forSampleRate(sampleRate > 0.0 ? sampleRate : 48000.0);
+        numChannels = std::clamp(channels, 0, kMaxChannels);
+        weights.fill(0.0);
+        for (int ch = 0; ch < numChannels; ++ch)
+            weights[(size_t) ch] = 1.0;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        shelfZ1.fill(0.0);
+        shelfZ2.fill(0.0);
+        hpZ1.fill(0.0);
+        hpZ2.fill(0.0);
+    }
+
+    // BS.1770 channel weight (1.0 for L/R/C, 1.41 for surrounds, 0 for LFE).
+    void setChannelWeight(int channel, double weight) noexcept
+    {
+        if (channel >= 0 && channel < numChannels)
+            weights[(size_t) channel] = weight;
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Real-time safe. Extra channels beyond prepare() are ignored.
+    double process(const float* const* channels, int channelCount, int numSamples) noexcept
+    {
+        const int active = std::min(channelCount, numChannels);
+        double energy = 0.0;
+        for (int base = 0; base < active; base += kLanes)
+            energy += processGroup(channels, base, std::min(kLanes, active - base), numSamples);
+        return energy;
+    }
+
+private:
+    double processGroup(const float* const* channels, int base, int lanesUsed, int numSamples) noexcept
+    {
+        const auto& s = coeffs.shelf;
+        const auto& h = coeffs.highpass;
+
+        alignas(32) double z1s[kLanes], z2s[kLanes], z1h[kLanes], z2h[kLanes], w[kLanes], acc[kLanes];
+        const float* src[kLanes];
+        for (int l = 0; l < kLanes; ++l)
+        {
+            const auto idx = (size_t) (base + l);
+            const bool used = l < lanesUsed;
+            z1s[l] = used ? shelfZ1[idx] : 0.0;
+            z2s[l] = used ? shelfZ2[idx] : 0.0;
+            z1h[l] = used ? hpZ1[idx] : 0.0;
+            z2h[l] = used ? hpZ2[idx] : 0.0;
+            w[l] = used ? weights[idx] : 0.0;
+            acc[l] = 0.0;
+            src[l] = used ? channels[base + l] : nullptr;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas(32) double x[kLanes];
+            for (int l = 0; l < kLanes; ++l)
+                x[l] = src[l] != nullptr ? (double) src[l][i] : 0.0;
+
+            // Transposed direct form II, both stages, all lanes in lock-step.
+            for (int l = 0; l < kLanes; ++l)
+            {
+                const double y1 = s.b0 * x[l] + z1s[l];
+                z1s[l] = s.b1 * x[l] - s.a1 * y1 + z2s[l];
+                z2s[l] = s.b2 * x[l] - s.a2 * y1;
+
+                const double y2 = h.b0 * y1 + z1h[l];
+                z1h[l] = h.b1 * y1 - h.a1 * y2 + z2h[l];
+                z2h[l] = h.b2 * y1 - h.a2 * y2;
+
+                acc[l] += w[l] * y2 * y2;
+            }
+        }
+
+        double energy = 0.0;
+        for (int l = 0; l < lanesUsed; ++l)
+        {
+            const auto idx = (size_t) (base + l);
+            shelfZ1[idx] = flushDenormal(z1s[l]);
+            shelfZ2[idx] = flushDenormal(z2s[l]);
+            hpZ1[idx] = flushDenormal(z1h[l]);
+            hpZ2[idx] = flushDenormal(z2h[l]);
+            energy += acc[l];
+        }
+        return energy;
+    }
+
+    static double flushDenormal(double v) noexcept { return std::abs(v) < 1.0e-30 ? 0.0 : v; }
+
+    KWeightingCoefficients coeffs;
+    int numChannels{0};
+    std::array<double, kMaxChannels> weights{};
+    std::array<double, kMaxChannels> shelfZ1{}, shelfZ2{}, hpZ1{}, hpZ2{};
+};
+
+// Block energy -> LUFS, per BS.1770 (-0.691 dB offset for the K-filter's 1 kHz gain).
+inline double energyToLufs(double meanSquare) noexcept
+{
+    return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare)
+                            : -std::numeric_limits<double>::infinity();
+}
+} // namespace ma::dsp
@@ -0,0 +1,93 @@
+#pragma once
+
+// One-pole low-pass (y += a * (x - y)) over any number of channels, in place.
+// State is a flat per-channel array; the per-sample loop walks a group of
+// lanes (one channel each, group width fixed at compile time) so the compiler
+// vectorises across channels, much as KWeightingFilterBank does. Header-only
+// and JUCE-free.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace ma::dsp
+{
+class OnePoleBank
+{
+public:
+    static constexpr int kLanes = 8;
+    static constexpr int kMaxChannels = 16; // 9.1.6
+
+    void prepare(int channels) noexcept
+    {
+        numChannels = std::clamp(channels, 0, kMaxChannels);
+        reset();
+    }
+
+    void reset() noexcept { state.fill(0.0f); }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // a = 1 - exp(-2*pi*fc/fs); shared by every channel.
+    static float coefficientFor(double cutoffHz, double sampleRate) noexcept
+    {
+        constexpr double twoPi = 6.28318530717958647692;
+        return sampleRate > 0.0 ? (float) (1.0 - std::exp(-twoPi * cutoffHz / sampleRate)) : 1.0f;
+    }
+
+    // Real-time safe. Channels beyond prepare() are left untouched.
+    void process(float* const* channels, int channelCount, int numSamples, float a) noexcept
+    {
+        // Split into 8/4/2/1-lane groups, so every lane is a real channel (stereo
+        // runs one 2-lane group) and the inner loop has no branches.
+        const int active = std::min(channelCount, numChannels);
+        int base = 0;
+        for (; active - base >= kLanes; base += kLanes)
+            processGroup<kLanes>(channels, base, numSamples, a);
+        if (active - base >= 4)
+        {
+            processGroup<4>(channels, base, numSamples, a);
+            base += 4;
+        }
+        if (active - base >= 2)
+        {
+            processGroup<2>(channels, base, numSamples, a);
+            base += 2;
+        }
+        if (active - base >= 1)
+            processGroup<1>(channels, base, numSamples, a);
+    }
+
+private:
+    template <int Lanes>
+    void processGroup(float* const* channels, int base, int numSamples, float a) noexcept
+    {
+        alignas(32) float y[Lanes];
+        float* dst[Lanes];
+        for (int l = 0; l < Lanes; ++l)
+        {
+            y[l] = state[(size_t) (base + l)];
+            dst[l] = channels[base + l];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas(32) float x[Lanes];
+            for (int l = 0; l < Lanes; ++l)
+                x[l] = dst[l][i];
+
+            for (int l = 0; l < Lanes; ++l)
+                y[l] += a * (x[l] - y[l]);
+
+            for (int l = 0; l < Lanes; ++l)
+                dst[l][i] = y[l];
+        }
+
+        for (int l = 0; l < Lanes; ++l)
+            state[(size_t) (base + l)] = std::abs(y[l]) < 1.0e-20f ? 0.0f : y[l];
+    }
+
+    int numChannels{0};
+    std::array<float, kMaxChannels> state{};
+};
+} // namespace ma::dsp
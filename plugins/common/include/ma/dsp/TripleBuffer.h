@@ -0,0 +1,49 @@
+#pragma once
+
+// Wait-free single-producer / single-consumer triple buffer for publishing the
+// latest value of a small struct (meter readings, status) from the audio thread
+// to the UI. The writer never blocks or fails; the reader always gets the most
+// recent complete value and never sees a torn one. Header-only and JUCE-free.
+
+#include <atomic>
+#include <cstdint>
+
+namespace ma::dsp
+{
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer thread only.
+    void write(const T& value) noexcept
+    {
+        slots[back].value = value;
+        back = middle.exchange((uint8_t) (back | kDirty), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Consumer thread only. Copies the latest value into `out`; returns true if it
+    // is newer than the previous read.
+    bool read(T& out) noexcept
+    {
+        const bool fresh = (middle.load(std::memory_order_acquire) & kDirty) != 0;
+        if (fresh)
+            front = middle.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        out = slots[front].value;
+        return fresh;
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirty = 0x4;
+
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    Slot slots[3];
+    uint8_t back{0};                 // producer-owned
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t front{2};    // consumer-owned
+};
+} // namespace ma::dsp
@@ -0,0 +1,109 @@
+#pragma once
+
+// 4x-oversampled true-peak detector (ITU-R BS.1770-4 Annex 2): a 48-tap
+// polyphase interpolator (12 taps per phase) per channel, reporting the
+// largest |sample| seen on the oversampled signal. Header-only and JUCE-free.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace ma::dsp
+{
+class TruePeakDetector
+{
+public:
+    static constexpr int kFactor = 4;
+    static constexpr int kTapsPerPhase = 12;
+    static constexpr int kMaxChannels = 16;
+
+    TruePeakDetector() noexcept { reset(); }
+
+    void prepare(int channels) noexcept
+    {
+        numChannels = std::clamp(channels, 0, kMaxChannels);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& h : history)
+            h.fill(0.0f);
+        writePos.fill(0);
+    }
+
+    // Real-time safe. Returns the oversampled peak of this block (linear).
+    float process(const float* const* channels, int channelCount, int numSamples) noexcept
+    {
+        const auto& taps = phaseTaps();
+        const int active = std::min(channelCount, numChannels);
+        float peak = 0.0f;
+
+        for (int ch = 0; ch < active; ++ch)
+        {
+            const float* src = channels[ch];
+            auto& hist = history[(size_t) ch];
+            int pos = writePos[(size_t) ch];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // Mirrored ring: the newest kTapsPerPhase samples are always contiguous.
+                pos = (pos == 0 ? kTapsPerPhase : pos) - 1;
+                hist[(size_t) pos] = src[i];
+                hist[(size_t) (pos + kTapsPerPhase)] = src[i];
+                const float* window = hist.data() + pos;
+
+                for (int p = 0; p < kFactor; ++p)
+                {
+                    const auto& h = taps[(size_t) p];
+                    float y = 0.0f;
+                    for (int k = 0; k < kTapsPerPhase; ++k)
+                        y += h[(size_t) k] * window[k];
+                    peak = std::max(peak, std::abs(y));
+                }
+            }
+            writePos[(size_t) ch] = pos;
+        }
+        return peak;
+    }
+
+private:
+    using PhaseTaps = std::array<std::array<float, kTapsPerPhase>, kFactor>;
+
+    // Windowed-sinc interpolator (cutoff at the original Nyquist), each phase
+    // normalised to unity DC gain. Computed once per process.
+    static const PhaseTaps& phaseTaps() noexcept
+    {
+        static const PhaseTaps taps = []
+        {
+            constexpr double pi = 3.14159265358979323846;
+            constexpr int numTaps = kFactor * kTapsPerPhase;
+            constexpr double centre = (numTaps - 1) / 2.0;
+
+            PhaseTaps t{};
+            for (int p = 0; p < kFactor; ++p)
+            {
+                double sum = 0.0;
+                for (int k = 0; k < kTapsPerPhase; ++k)
+                {
+                    const int n = p + k * kFactor;
+                    const double x = ((double) n - centre) / (double) kFactor;
+                    const double sinc = std::abs(x) < 1.0e-12 ? 1.0 : std::sin(pi * x) / (pi * x);
+                    const double blackman = 0.42 - 0.5 * std::cos(2.0 * pi * (n + 0.5) / numTaps)
+                                          + 0.08 * std::cos(4.0 * pi * (n + 0.5) / numTaps);
+                    t[(size_t) p][(size_t) k] = (float) (sinc * blackman);
+                    sum += sinc * blackman;
+                }
+                for (auto& c : t[(size_t) p])
+                    c = (float) (c / sum);
+            }
+            return t;
+        }();
+        return taps;
+    }
+
+    int numChannels{0};
+    std::array<std::array<float, 2 * kTapsPerPhase>, kMaxChannels> history{};
+    std::array<int, kMaxChannels> writePos{};
+};
+} // namespace ma::dsp
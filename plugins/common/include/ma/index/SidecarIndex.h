@@ -0,0 +1,238 @@
+#pragma once
+
+// Append-only index of sidecar snapshots, one file per data root
+// (`features_output/juce_probe/juce_probe_index.bin`). Writers append one
+// fixed-width record per snapshot, so consumers can look up a track or scan a
+// time range by reading the file instead of walking snapshot directories.
+//
+// File: a 64-byte IndexFileHeader, then IndexRecord[n] (384 bytes each),
+// little-endian, in append order. n = (fileSize - headerBytes) / recordBytes.
+// Each record carries a CRC-32 of its bytes (with the crc field zeroed), so a
+// record torn by a crash can be told apart from a complete one.
+//
+// Appends are atomic: writers serialise on an advisory lock over the whole file
+// (fcntl, which NFS/SMB clients also honour; _locking on Windows) plus an
+// in-process mutex, trim a torn tail left by a crashed writer, write the record
+// with one write() and fsync before unlocking. Header-only and JUCE-free.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+ #include <fcntl.h>
+ #include <io.h>
+ #include <sys/locking.h>
+ #include <sys/stat.h>
+#else
+ #include <fcntl.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+namespace ma::index
+{
+inline constexpr char kIndexFileName[] = "juce_probe_index.bin";
+inline constexpr char kFileMagic[8] = { 'M', 'A', 'P', 'R', 'I', 'D', 'X', '1' };
+inline constexpr uint32_t kRecordMagic = 0x5844494D; // "MIDX"
+inline constexpr uint16_t kVersion = 1;
+
+enum RecordFlags : uint32_t
+{
+    kFlagPathTruncated = 1u << 0, // relativePath did not fit; walk the track folder instead
+    kFlagIdTruncated = 1u << 1,   // trackId or sessionId was cut at 63 bytes
+};
+
+struct IndexFileHeader
+{
+    char magic[8];        // kFileMagic
+    uint32_t version;     // kVersion
+    uint32_t headerBytes; // offset of record 0
+    uint32_t recordBytes;
+    uint8_t reserved[44];
+};
+
+// Unmeasured values are NaN (e.g. the UI demo has no loudness or tempo stage).
+struct IndexRecord
+{
+    uint32_t magic;       // kRecordMagic
+    uint16_t version;     // kVersion
+    uint16_t recordBytes; // sizeof(IndexRecord)
+    uint32_t flags;       // RecordFlags
+    uint32_t crc;         // CRC-32 (IEEE) of the record with this field zeroed
+    int64_t writtenAtMs;  // unix time the snapshot was written
+    double durationSec;
+    double sampleRate;
+    double integratedLufs;
+    double integratedRmsDb;
+    double peakDb;
+    double truePeakDbtp;
+    double crestDb;
+    double maxMomentaryLufs;
+    double maxShortTermLufs;
+    double bpm;
+    char trackId[64];     // NUL-padded UTF-8
+    char sessionId[64];
+    char source[16];      // writer, e.g. "juce_probe", "juce_ui_demo"
+    char relativePath[136]; // sidecar path relative to the index's folder, '/' separated
+};
+
+static_assert(sizeof(IndexFileHeader) == 64);
+static_assert(offsetof(IndexRecord, writtenAtMs) == 16);
+static_assert(offsetof(IndexRecord, trackId) == 104);
+static_assert(offsetof(IndexRecord, relativePath) == 248);
+static_assert(sizeof(IndexRecord) == 384);
+
+// A record with every measurement NaN and all strings empty.
+inline IndexRecord makeRecord() noexcept
+{
+    IndexRecord record;
+    std::memset(&record, 0, sizeof(record));
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    for (double* field : { &record.durationSec, &record.sampleRate, &record.integratedLufs, &record.integratedRmsDb,
+                           &record.peakDb, &record.truePeakDbtp, &record.crestDb, &record.maxMomentaryLufs,
+                           &record.maxShortTermLufs, &record.bpm })
+        *field = nan;
+    return record;
+}
+
+// NUL-padded copy that never splits a UTF-8 sequence. Returns false if truncated.
+template <size_t N>
+bool setField(char (&dest)[N], std::string_view utf8) noexcept
+{
+    auto length = std::min(utf8.size(), N - 1);
+    while (length > 0 && length < utf8.size() && (((unsigned char) utf8[length]) & 0xC0) == 0x80)
+        --length;
+    std::memset(dest, 0, N);
+    std::memcpy(dest, utf8.data(), length);
+    return length == utf8.size();
+}
+
+inline uint32_t crc32(const void* data, size_t size) noexcept
+{
+    auto crc = 0xFFFFFFFFu;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+inline uint32_t recordCrc(const IndexRecord& record) noexcept
+{
+    auto copy = record;
+    copy.crc = 0;
+    return crc32(&copy, sizeof(copy));
+}
+
+inline bool isValid(const IndexRecord& record) noexcept
+{
+    return record.magic == kRecordMagic && record.version == kVersion
+        && record.recordBytes == sizeof(IndexRecord) && record.crc == recordCrc(record);
+}
+
+namespace detail
+{
+#if defined(_WIN32)
+inline int openIndex(const std::filesystem::path& path)
+{
+    int fd = -1;
+    return _wsopen_s(&fd, path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) == 0 ? fd : -1;
+}
+// _locking covers bytes from the current position; byte 0 stands for the whole file.
+inline bool lockIndex(int fd) { return _lseeki64(fd, 0, SEEK_SET) == 0 && _locking(fd, _LK_LOCK, 1) == 0; }
+inline void unlockIndex(int fd) { _lseeki64(fd, 0, SEEK_SET); _locking(fd, _LK_UNLCK, 1); }
+inline int64_t fileSize(int fd) { struct _stat64 info{}; return _fstat64(fd, &info) == 0 ? (int64_t) info.st_size : -1; }
+inline bool truncateTo(int fd, int64_t size) { return _chsize_s(fd, size) == 0; }
+inline bool writeAt(int fd, int64_t offset, const void* data, size_t size)
+{
+    return _lseeki64(fd, offset, SEEK_SET) == offset && _write(fd, data, (unsigned) size) == (int) size;
+}
+inline bool sync(int fd) { return _commit(fd) == 0; }
+inline void closeIndex(int fd) { _close(fd); }
+#else
+inline int openIndex(const std::filesystem::path& path) { return ::open(path.c_str(), O_RDWR | O_CREAT, 0644); }
+inline bool lockIndex(int fd)
+{
+    struct flock lock{};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET; // l_start = l_len = 0: the whole file, including future appends
+    return fcntl(fd, F_SETLKW, &lock) == 0;
+}
+inline void unlockIndex(int fd)
+{
+    struct flock lock{};
+    lock.l_type = F_UNLCK;
+    lock.l_whence = SEEK_SET;
+    fcntl(fd, F_SETLK, &lock);
+}
+inline int64_t fileSize(int fd) { struct stat info{}; return fstat(fd, &info) == 0 ? (int64_t) info.st_size : -1; }
+inline bool truncateTo(int fd, int64_t size) { return ftruncate(fd, (off_t) size) == 0; }
+inline bool writeAt(int fd, int64_t offset, const void* data, size_t size)
+{
+    return pwrite(fd, data, size, (off_t) offset) == (ssize_t) size;
+}
+inline bool sync(int fd) { return fsync(fd) == 0; }
+inline void closeIndex(int fd) { ::close(fd); }
+#endif
+} // namespace detail
+
+// Appends `record` (magic, version, size and CRC are filled in) to the index at
+// `indexPathUtf8`, creating the file if needed. Blocks while another writer holds
+// the lock; returns false on I/O errors. Not for the audio thread.
+inline bool appendRecord(const std::string& indexPathUtf8, IndexRecord record)
+{
+    record.magic = kRecordMagic;
+    record.version = kVersion;
+    record.recordBytes = (uint16_t) sizeof(IndexRecord);
+    record.crc = recordCrc(record);
+
+    // fcntl locks are per process (and dropped by any close() of the file), so
+    // threads in one process also serialise here.
+    static std::mutex processMutex;
+    const std::lock_guard<std::mutex> guard(processMutex);
+
+    const int fd = detail::openIndex(std::filesystem::u8path(indexPathUtf8));
+    if (fd < 0)
+        return false;
+
+    bool ok = detail::lockIndex(fd);
+    if (ok)
+    {
+        auto size = detail::fileSize(fd);
+        if (size < (int64_t) sizeof(IndexFileHeader))
+        {
+            IndexFileHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+            header.version = kVersion;
+            header.headerBytes = (uint32_t) sizeof(IndexFileHeader);
+            header.recordBytes = (uint32_t) sizeof(IndexRecord);
+            ok = detail::truncateTo(fd, 0) && detail::writeAt(fd, 0, &header, sizeof(header));
+            size = (int64_t) sizeof(header);
+        }
+
+        // A writer that died mid-append leaves a partial record; drop it.
+        const auto tail = (size - (int64_t) sizeof(IndexFileHeader)) % (int64_t) sizeof(IndexRecord);
+        if (ok && tail != 0)
+        {
+            size -= tail;
+            ok = detail::truncateTo(fd, size);
+        }
+
+        ok = ok && detail::writeAt(fd, size, &record, sizeof(record)) && detail::sync(fd);
+        detail::unlockIndex(fd);
+    }
+    detail::closeIndex(fd);
+    return ok;
+}
+} // namespace ma::index
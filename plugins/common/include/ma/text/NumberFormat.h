@@ -0,0 +1,86 @@
+#pragma once
+
+// Locale-independent number formatting for the JSON writers. The printf family
+// follows the process LC_NUMERIC locale, so in a host that calls
+// setlocale(LC_ALL, "") "%g" writes "-14,2" and the document stops being JSON.
+// These always write '.': std::to_chars where the standard library has the
+// floating-point overloads, otherwise snprintf with the locale's decimal
+// separator swapped back. Header-only and JUCE-free.
+
+#include <charconv>
+#include <clocale>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+ #define MA_TEXT_HAS_FLOAT_TO_CHARS 1
+#else
+ #define MA_TEXT_HAS_FLOAT_TO_CHARS 0 // e.g. libc++ for older macOS deployment targets
+#endif
+
+namespace ma::text
+{
+// Room for any double in either format below, plus a terminator.
+inline constexpr size_t kNumberBufferBytes = 48;
+
+namespace detail
+{
+#if ! MA_TEXT_HAS_FLOAT_TO_CHARS
+// snprintf output of `length` chars; rewrites a non-"." decimal separator in place.
+inline size_t withDotDecimal(char* buffer, size_t length) noexcept
+{
+    const auto* conv = std::localeconv();
+    const char* point = conv != nullptr ? conv->decimal_point : nullptr;
+    if (point == nullptr || point[0] == '\0' || std::strcmp(point, ".") == 0)
+        return length;
+
+    auto* found = std::strstr(buffer, point);
+    if (found == nullptr)
+        return length;
+    const auto pointLength = std::strlen(point);
+    *found = '.';
+    std::memmove(found + 1, found + pointLength, length - (size_t) (found - buffer) - pointLength + 1);
+    return length - (pointLength - 1);
+}
+
+inline size_t printfNumber(char* buffer, size_t size, const char* format, int precision, double value) noexcept
+{
+    const auto length = std::snprintf(buffer, size, format, precision, value);
+    if (length < 0 || (size_t) length >= size)
+        return 0;
+    return withDotDecimal(buffer, (size_t) length);
+}
+#endif
+} // namespace detail
+
+// As "%.*g" in the C locale. `buffer` should hold kNumberBufferBytes; returns
+// the length written (not NUL-terminated), or 0 if it did not fit.
+inline size_t formatGeneral(char* buffer, size_t size, double value, int significantDigits) noexcept
+{
+#if MA_TEXT_HAS_FLOAT_TO_CHARS
+    const auto result = std::to_chars(buffer, buffer + size, value, std::chars_format::general, significantDigits);
+    return result.ec == std::errc() ? (size_t) (result.ptr - buffer) : 0;
+#else
+    return detail::printfNumber(buffer, size, "%.*g", significantDigits, value);
+#endif
+}
+
+// As "%.*f" in the C locale.
+inline size_t formatFixed(char* buffer, size_t size, double value, int decimals) noexcept
+{
+#if MA_TEXT_HAS_FLOAT_TO_CHARS
+    const auto result = std::to_chars(buffer, buffer + size, value, std::chars_format::fixed, decimals);
+    return result.ec == std::errc() ? (size_t) (result.ptr - buffer) : 0;
+#else
+    return detail::printfNumber(buffer, size, "%.*f", decimals, value);
+#endif
+}
+
+inline size_t formatInteger(char* buffer, size_t size, int64_t value) noexcept
+{
+    const auto result = std::to_chars(buffer, buffer + size, value);
+    return result.ec == std::errc() ? (size_t) (result.ptr - buffer) : 0;
+}
+} // namespace ma::text
@@ -2,11 +2,12 @@
 
 #include <JuceHeader.h>
 #include <cstdlib>
+#include <ma/tokens/MaTokens.h>
 
 MusicAdvisorProbeAudioProcessorEditor::MusicAdvisorProbeAudioProcessorEditor(MusicAdvisorProbeAudioProcessor& p)
     : juce::AudioProcessorEditor(&p), processor(p)
 {
-    setSize(460, 260);
+    setSize(460, 320);
 
     titleLabel.setText("Music Advisor Probe", juce::dontSendNotification);
     titleLabel.setJustificationType(juce::Justification::centredLeft);
@@ -26,6 +27,16 @@ MusicAdvisorProbeAudioProcessorEditor::MusicAdvisorProbeAudioProcessorEditor(Mus
 
     snapshotButton.onClick = [this] { triggerSnapshot(); };
 
+    liveToggle.setTooltip("Append the timeline to one per-session file while playing.");
+    liveToggle.setToggleState(processor.isLiveCapturing(), juce::dontSendNotification);
+    liveToggle.onClick = [this]
+    {
+        processor.setLiveCaptureFromUI(liveToggle.getToggleState(),
+                                       trackField.getText().trim(),
+                                       sessionField.getText().trim(),
+                                       dataRootField.getText().trim());
+    };
+
     captureAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         processor.getValueTreeState(), "capture_enabled", captureToggle);
 
@@ -39,23 +50,54 @@ MusicAdvisorProbeAudioProcessorEditor::MusicAdvisorProbeAudioProcessorEditor(Mus
     addAndMakeVisible(dataRootField);
     addAndMakeVisible(snapshotButton);
     addAndMakeVisible(captureToggle);
+    addAndMakeVisible(liveToggle);
 
     startTimerHz(5);
 }
 
 void MusicAdvisorProbeAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    g.fillAll(juce::Colours::darkslategrey.darker(0.4f));
+    g.fillAll(juce::Colour(ma::tokens::colour::background));
     g.setColour(juce::Colours::white);
     g.setFont(juce::Font(14.0f));
+    paintOverview(g);
+}
+
+// Peak (dim) over mean RMS per column, -60..0 dBFS; gaps where capture was off.
+void MusicAdvisorProbeAudioProcessorEditor::paintOverview(juce::Graphics& g) const
+{
+    const auto area = overviewArea.toFloat();
+    g.setColour(juce::Colour(ma::tokens::colour::metricBG));
+    g.fillRect(area);
+
+    const auto toY = [area](float linear)
+    {
+        const auto db = juce::jlimit(-60.0f, 0.0f, juce::Decibels::gainToDecibels(linear, -60.0f));
+        return area.getBottom() - area.getHeight() * (db + 60.0f) / 60.0f;
+    };
+    const auto colour = juce::Colour(ma::tokens::colour::primary);
+    for (size_t x = 0; x < overviewColumns.size(); ++x)
+    {
+        const auto& column = overviewColumns[x];
+        if (column.isEmpty())
+            continue;
+        const auto left = area.getX() + (float) x;
+        const auto peakY = toY(column.peak);
+        const auto rmsY = toY(std::sqrt(column.meanSquare));
+        g.setColour(colour.withAlpha(0.35f));
+        g.fillRect(left, peakY, 1.0f, area.getBottom() - peakY);
+        g.setColour(colour);
+        g.fillRect(left, rmsY, 1.0f, area.getBottom() - rmsY);
+    }
 }
 
 void MusicAdvisorProbeAudioProcessorEditor::resized()
 {
     auto area = getLocalBounds().reduced(12);
     auto header = area.removeFromTop(30);
-    titleLabel.setBounds(header.removeFromLeft(area.getWidth() - 110));
-    captureToggle.setBounds(header);
+    titleLabel.setBounds(header.removeFromLeft(area.getWidth() - 180));
+    captureToggle.setBounds(header.removeFromLeft(100));
+    liveToggle.setBounds(header);
 
     const int rowHeight = 26;
     const int labelWidth = 140;
@@ -86,6 +128,9 @@ void MusicAdvisorProbeAudioProcessorEditor::resized()
     snapshotButton.setBounds(buttonRow.removeFromLeft(160));
     buttonRow.removeFromLeft(spacing);
     statusLabel.setBounds(buttonRow);
+
+    area.removeFromTop(spacing);
+    overviewArea = area;
 }
 
 void MusicAdvisorProbeAudioProcessorEditor::triggerSnapshot()
@@ -107,6 +152,14 @@ void MusicAdvisorProbeAudioProcessorEditor::timerCallback()
     {
         status = "Writing snapshot...";
     }
+    else if (processor.isNonRealtime())
+    {
+        status = "Offline render \u2022 sidecar written when it ends";
+    }
+    else if (processor.isLiveCapturing())
+    {
+        status = "Live: " + processor.getLiveCapturePath();
+    }
     else if (auto last = processor.getLastSnapshotPath(); last.isNotEmpty())
     {
         status = "Last: " + last;
@@ -116,5 +169,24 @@ void MusicAdvisorProbeAudioProcessorEditor::timerCallback()
         status = "Ready • Host: " + processor.getHostName();
     }
 
+    // Hot-path summary, so a glitch report can say whether the probe was behind it.
+    const auto t = processor.getTelemetryReport();
+    if (t.blocks > 0)
+    {
+        status << " • load p99 " << juce::String(t.p99LoadPct, 1) << "% max " << juce::String(t.maxLoadPct, 1) << "%";
+        if (t.deadlineOverruns > 0)
+            status << " (" << juce::String(t.deadlineOverruns) << " over)";
+        if (const auto dropped = processor.getDroppedFrameCount(); dropped > 0)
+            status << " • dropped " << juce::String(dropped);
+    }
+
     statusLabel.setText(status, juce::dontSendNotification);
+    statusLabel.setTooltip(status);
+
+    // Cheap at any session length: the pyramid pools a handful of bins per column.
+    if (overviewArea.getWidth() > 0)
+    {
+        processor.readOverview(0.0, processor.getOverviewEndSec(), overviewArea.getWidth(), overviewColumns);
+        repaint(overviewArea);
+    }
 }
@@ -17,6 +17,7 @@ public:
 private:
     void triggerSnapshot();
     void timerCallback() override;
+    void paintOverview(juce::Graphics&) const;
 
     MusicAdvisorProbeAudioProcessor& processor;
 
@@ -32,8 +33,13 @@ private:
 
     juce::TextButton snapshotButton{"Write Snapshot"};
     juce::ToggleButton captureToggle{"Capture"};
+    juce::ToggleButton liveToggle{"Live"};
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> captureAttachment;
 
+    // Whole-session level overview, one pyramid column per pixel.
+    juce::Rectangle<int> overviewArea;
+    std::vector<TimelinePyramid::Bin> overviewColumns;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MusicAdvisorProbeAudioProcessorEditor)
 };
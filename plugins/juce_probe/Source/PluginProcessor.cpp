@@ -1,7 +1,19 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "dsp/SidecarSchema.h"
 
 #include <JuceHeader.h>
+#include <cstdlib>
+
+namespace
+{
+double envMinutes(const char* name, double fallbackMinutes)
+{
+    if (auto* env = std::getenv(name); env != nullptr && *env != '\0')
+        return juce::String(env).getDoubleValue();
+    return fallbackMinutes;
+}
+} // namespace
 
 MusicAdvisorProbeAudioProcessor::MusicAdvisorProbeAudioProcessor()
     : juce::AudioProcessor(BusesProperties()
@@ -14,6 +26,35 @@ MusicAdvisorProbeAudioProcessor::MusicAdvisorProbeAudioProcessor()
 
     juce::PluginHostType hostType;
     hostName = hostType.getHostDescription();
+
+    if (auto* env = std::getenv("MA_PROBE_COLUMNAR"); env != nullptr)
+        columnarSidecarEnabled = juce::String(env).getIntValue() != 0;
+
+    if (auto* env = std::getenv("MA_PROBE_DIAGNOSTICS"); env != nullptr)
+        diagnosticsSidecarEnabled = juce::String(env).getIntValue() != 0;
+
+    if (auto* env = std::getenv("MA_PROBE_PYRAMID_LEVELS"); env != nullptr)
+        pyramidLevels = SidecarSchema::parsePyramidLevels(env);
+
+    if (auto* env = std::getenv("MA_PROBE_LIVE_BUS"); env != nullptr)
+        collector.setLiveBusEnabled(juce::String(env).getIntValue() != 0);
+    collector.setLiveBusIdentity(getTrackId(), getSessionId());
+
+    if (auto* env = std::getenv("MA_PROBE_LIVE_INTERVAL_SEC"); env != nullptr && *env != '\0')
+        liveFlushIntervalSec = juce::jmax(0.1, juce::String(env).getDoubleValue());
+
+    TimelineStore::Config timelineConfig;
+    timelineConfig.maxSessionSec = envMinutes("MA_PROBE_MAX_SESSION_MIN", timelineConfig.maxSessionSec / 60.0) * 60.0;
+    timelineConfig.ringWindowSec = envMinutes("MA_PROBE_TIMELINE_RING_MIN", 0.0) * 60.0;
+    collector.setTimelineConfig(timelineConfig);
+
+    if (auto* env = std::getenv("MA_PROBE_SPECTRAL"); env != nullptr)
+        spectralConfig.enabled = juce::String(env).getIntValue() != 0;
+    if (auto* env = std::getenv("MA_PROBE_SPECTRAL_CPU_PCT"); env != nullptr && *env != '\0')
+        spectralConfig.cpuBudgetFraction = juce::String(env).getDoubleValue() / 100.0;
+    if (auto* env = std::getenv("MA_PROBE_OFFLINE_SPECTRAL"); env != nullptr)
+        offlineSpectralEnabled = juce::String(env).getIntValue() != 0;
+
    #if defined(JucePlugin_VersionString)
     buildId = JucePlugin_VersionString;
    #endif
@@ -28,12 +69,57 @@ void MusicAdvisorProbeAudioProcessor::prepareToPlay(double sampleRate, int sampl
 {
     juce::ignoreUnused(samplesPerBlock);
     samplesProcessed = 0.0;
-    collector.prepare(sampleRate, samplesPerBlock);
+    numStagedFrames = 0;
+    stagedSamples = 0;
+    frameAnalyzer.prepare(sampleRate, getChannelLayoutOfBus(true, 0));
+
+    // A bounce can afford the spectral stage even when live playback cannot.
+    auto spectral = spectralConfig;
+    spectral.enabled = spectral.enabled || (isNonRealtime() && offlineSpectralEnabled);
+    collector.setSpectralConfig(spectral);
+    collector.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
 }
 
 void MusicAdvisorProbeAudioProcessor::releaseResources()
 {
-    collector.reset();
+    // Some hosts end a bounce by releasing without switching back to realtime.
+    if (isNonRealtime())
+        collector.writeOfflineSnapshot(makeSnapshotRequest({}));
+    flushStagedFrames(); // the tail of playback still reaches live capture
+    collector.release();
+}
+
+void MusicAdvisorProbeAudioProcessor::setNonRealtime(bool shouldBeNonRealtime) noexcept
+{
+    const bool wasNonRealtime = isNonRealtime();
+    juce::AudioProcessor::setNonRealtime(shouldBeNonRealtime);
+    if (wasNonRealtime == shouldBeNonRealtime)
+        return;
+
+    // Hosts switch modes with audio stopped. A render starts its own session;
+    // the end of one queues its sidecar.
+    if (shouldBeNonRealtime)
+    {
+        // Discarding staged realtime frames is intended: the collector resets
+        // its session for the render too.
+        samplesProcessed = 0.0;
+        numStagedFrames = 0;
+        stagedSamples = 0;
+    }
+    else
+    {
+        // noexcept: the sidecar is written by the writer thread once the
+        // collector rejoins it below, never here.
+        try
+        {
+            collector.queueOfflineSnapshot(makeSnapshotRequest({}));
+        }
+        catch (const std::exception& e)
+        {
+            juce::Logger::writeToLog("MAProbe: offline sidecar not queued: " + juce::String(e.what()));
+        }
+    }
+    collector.setNonRealtime(shouldBeNonRealtime);
 }
 
 bool MusicAdvisorProbeAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -51,6 +137,7 @@ void MusicAdvisorProbeAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
 {
     juce::ScopedNoDenormals noDenormals;
     juce::ignoreUnused(midiMessages);
+    const auto startTicks = juce::Time::getHighResolutionTicks();
 
     const auto totalNumInputChannels = getTotalNumInputChannels();
     const auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -61,37 +148,42 @@ void MusicAdvisorProbeAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
     const auto numSamples = buffer.getNumSamples();
     if (captureEnabled && buffer.getNumChannels() > 0 && numSamples > 0)
     {
-        auto frame = makeFrame(buffer, numSamples);
-        collector.pushFrame(frame);
+        collector.pushSamples(buffer.getArrayOfReadPointers(), totalNumInputChannels, numSamples);
+        stagedSamples += numSamples;
+        stageFrame(makeFrame(buffer, numSamples));
+    }
+    else
+    {
+        flushStagedFrames();
     }
 
     samplesProcessed += numSamples;
+
+    const auto elapsedSec = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    collector.getTelemetry().recordBlock(elapsedSec, numSamples, getSampleRate());
 }
 
 ProbeFrame MusicAdvisorProbeAudioProcessor::makeFrame(const juce::AudioBuffer<float>& buffer,
-                                                      int numSamples) const
+                                                      int numSamples)
 {
-    const int numChannels = buffer.getNumChannels();
-    double sumSquares = 0.0;
-    float peakLinear = 0.0f;
+    return frameAnalyzer.analyse(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), numSamples,
+                                 samplesProcessed / std::max(1.0, getSampleRate()));
+}
 
-    for (int ch = 0; ch < numChannels; ++ch)
-    {
-        const auto* channelData = buffer.getReadPointer(ch);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float sample = channelData[i];
-            sumSquares += (double) sample * (double) sample;
-            peakLinear = std::max(peakLinear, std::abs(sample));
-        }
-    }
+void MusicAdvisorProbeAudioProcessor::stageFrame(const ProbeFrame& frame)
+{
+    stagedFrames[(size_t) numStagedFrames++] = frame;
+    // Offline the push is the analysis itself, so nothing is left staged at the end of a render.
+    if (numStagedFrames == kMaxStagedFrames || stagedSamples >= kStagedSampleTarget || isNonRealtime())
+        flushStagedFrames();
+}
 
-    ProbeFrame frame;
-    frame.sampleCount = numSamples * numChannels;
-    frame.sumSquares = sumSquares;
-    frame.peakLinear = peakLinear;
-    frame.timestampSec = samplesProcessed / std::max(1.0, getSampleRate());
-    return frame;
+void MusicAdvisorProbeAudioProcessor::flushStagedFrames()
+{
+    if (numStagedFrames > 0)
+        collector.pushFrames(stagedFrames.data(), numStagedFrames);
+    numStagedFrames = 0;
+    stagedSamples = 0;
 }
 
 bool MusicAdvisorProbeAudioProcessor::hasEditor() const
@@ -138,13 +230,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout MusicAdvisorProbeAudioProces
     return { params.begin(), params.end() };
 }
 
-void MusicAdvisorProbeAudioProcessor::requestSnapshotFromUI(const juce::String& trackId,
-                                                            const juce::String& sessionId,
-                                                            const juce::String& dataRootOverride)
+SnapshotRequest MusicAdvisorProbeAudioProcessor::makeSnapshotRequest(const juce::String& dataRootOverride) const
 {
-    setTrackId(trackId);
-    setSessionId(sessionId);
-
     SnapshotRequest req;
     req.trackId = getTrackId();
     req.sessionId = getSessionId();
@@ -152,7 +239,45 @@ void MusicAdvisorProbeAudioProcessor::requestSnapshotFromUI(const juce::String&
     req.hostName = getHostName();
     req.sampleRate = getSampleRate();
     req.buildId = buildId;
-    collector.requestSnapshot(req);
+    req.writeColumnarTimeline = columnarSidecarEnabled;
+    req.includeDiagnostics = diagnosticsSidecarEnabled;
+    req.pyramidLevels = pyramidLevels;
+    return req;
+}
+
+void MusicAdvisorProbeAudioProcessor::requestSnapshotFromUI(const juce::String& trackId,
+                                                            const juce::String& sessionId,
+                                                            const juce::String& dataRootOverride)
+{
+    setTrackId(trackId);
+    setSessionId(sessionId);
+    collector.requestSnapshot(makeSnapshotRequest(dataRootOverride));
+}
+
+void MusicAdvisorProbeAudioProcessor::setLiveCaptureFromUI(bool enabled,
+                                                           const juce::String& trackId,
+                                                           const juce::String& sessionId,
+                                                           const juce::String& dataRootOverride)
+{
+    if (! enabled)
+    {
+        collector.stopLiveCapture();
+        return;
+    }
+
+    setTrackId(trackId);
+    setSessionId(sessionId);
+    collector.startLiveCapture(makeSnapshotRequest(dataRootOverride), liveFlushIntervalSec);
+}
+
+bool MusicAdvisorProbeAudioProcessor::isLiveCapturing() const
+{
+    return collector.isLiveCapturing();
+}
+
+juce::String MusicAdvisorProbeAudioProcessor::getLiveCapturePath() const
+{
+    return collector.getLiveCapturePath();
 }
 
 juce::String MusicAdvisorProbeAudioProcessor::getLastSnapshotPath() const
@@ -168,11 +293,13 @@ bool MusicAdvisorProbeAudioProcessor::isWritingSnapshot() const
 void MusicAdvisorProbeAudioProcessor::setTrackId(const juce::String& trackId)
 {
     metaState.setProperty("trackId", trackId, nullptr);
+    collector.setLiveBusIdentity(trackId, getSessionId());
 }
 
 void MusicAdvisorProbeAudioProcessor::setSessionId(const juce::String& sessionId)
 {
     metaState.setProperty("sessionId", sessionId, nullptr);
+    collector.setLiveBusIdentity(getTrackId(), sessionId);
 }
 
 juce::String MusicAdvisorProbeAudioProcessor::getTrackId() const
@@ -2,7 +2,10 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 
+#include <array>
+
 #include "dsp/FeatureCollector.h"
+#include "dsp/FrameAnalyzer.h"
 
 class MusicAdvisorProbeAudioProcessor : public juce::AudioProcessor
 {
@@ -13,6 +16,9 @@ public:
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    // Offline bounces: lossless aggregation on the render thread, spectral stage
+    // on (MA_PROBE_OFFLINE_SPECTRAL), and a sidecar when the render ends.
+    void setNonRealtime(bool shouldBeNonRealtime) noexcept override;
 
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
@@ -45,8 +51,21 @@ public:
     void requestSnapshotFromUI(const juce::String& trackId,
                                const juce::String& sessionId,
                                const juce::String& dataRootOverride);
+    void setLiveCaptureFromUI(bool enabled,
+                              const juce::String& trackId,
+                              const juce::String& sessionId,
+                              const juce::String& dataRootOverride);
     juce::String getLastSnapshotPath() const;
+    bool isLiveCapturing() const;
+    juce::String getLiveCapturePath() const;
     bool isWritingSnapshot() const;
+    ProbeTelemetry::Report getTelemetryReport() const { return collector.getTelemetry().report(); }
+    int64_t getDroppedFrameCount() const { return collector.getDroppedFrameCount(); }
+    void readOverview(double startSec, double endSec, int numColumns, std::vector<TimelinePyramid::Bin>& columns) const
+    {
+        collector.readOverview(startSec, endSec, numColumns, columns);
+    }
+    double getOverviewEndSec() const { return collector.getOverviewEndSec(); }
     void setTrackId(const juce::String& trackId);
     void setSessionId(const juce::String& sessionId);
     juce::String getTrackId() const;
@@ -55,15 +74,32 @@ public:
 
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    ProbeFrame makeFrame(const juce::AudioBuffer<float>& buffer, int numSamples) const;
+    ProbeFrame makeFrame(const juce::AudioBuffer<float>& buffer, int numSamples);
+    SnapshotRequest makeSnapshotRequest(const juce::String& dataRootOverride) const;
+    void stageFrame(const ProbeFrame& frame);
+    void flushStagedFrames();
 
     FeatureCollector collector;
+    FrameAnalyzer frameAnalyzer;
     juce::AudioProcessorValueTreeState apvts;
     juce::ValueTree metaState{ "Meta" };
 
+    // Small blocks are staged on the audio thread and handed to the FIFO as one span.
+    static constexpr int kMaxStagedFrames = 32;
+    static constexpr int kStagedSampleTarget = 1024; // per channel, ~21 ms at 48 kHz
+    std::array<ProbeFrame, kMaxStagedFrames> stagedFrames{};
+    int numStagedFrames{ 0 };
+    int stagedSamples{ 0 };
+
     double samplesProcessed{ 0.0 };
     juce::String hostName{"UnknownHost"};
     juce::String buildId{"dev"};
+    bool columnarSidecarEnabled{ false };
+    bool diagnosticsSidecarEnabled{ false };
+    bool offlineSpectralEnabled{ true };
+    SpectralAnalyzer::Config spectralConfig;
+    uint32_t pyramidLevels{ 0 };
+    double liveFlushIntervalSec{ 2.0 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MusicAdvisorProbeAudioProcessor)
 };
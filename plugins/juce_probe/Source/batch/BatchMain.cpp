@@ -0,0 +1,298 @@
+// ma_probe_batch: offline analyzer that runs the probe's DSP core over audio
+// files and writes the same juce_probe_features.json sidecars as the plugin.
+//
+//   ma_probe_batch [options] <file-or-directory>...
+//     --out <dir>        data root (default: $MA_DATA_ROOT or ~/music-advisor/data)
+//     --session <id>     session_id for every sidecar (default "batch")
+//     --jobs <n>         worker threads (default: all cores)
+//     --block <n>        analysis block size in samples (default 512, like a typical host)
+//     --recursive        descend into sub-directories
+//     --columnar         also write juce_probe_timeline.bin
+//     --pyramid <list>   add timeline pyramid levels, e.g. "1,10" (bin seconds) or "all"
+//     --spectral         run the STFT spectral stage (no CPU budget offline)
+//
+// Prints one tab-separated line per input on stdout (ok/fail, input, sidecar or
+// reason, audio seconds, speed vs real time); exits non-zero if any input failed.
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include "../dsp/FeatureCollector.h"
+#include "../dsp/FrameAnalyzer.h"
+#include "../dsp/SidecarSchema.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <set>
+
+namespace
+{
+constexpr int kDefaultBlockSize = 512;
+
+#if defined(MA_PROBE_BUILD_ID)
+const char* const kBuildId = MA_PROBE_BUILD_ID;
+#else
+const char* const kBuildId = "dev";
+#endif
+
+struct BatchOptions
+{
+    juce::String dataRoot;
+    juce::String sessionId{"batch"};
+    int blockSize{kDefaultBlockSize};
+    bool columnar{false};
+    uint32_t pyramidLevels{0};
+    bool spectral{false};
+};
+
+struct BatchJob
+{
+    juce::File input;
+    juce::String trackId;
+};
+
+struct BatchResult
+{
+    bool ok{false};
+    juce::String detail; // sidecar path or failure reason
+    double audioSec{0.0};
+    double wallSec{0.0};
+};
+
+BatchResult analyseFile(const BatchJob& job, const BatchOptions& options)
+{
+    BatchResult result;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(job.input));
+    if (reader == nullptr)
+    {
+        result.detail = "unsupported or unreadable file";
+        return result;
+    }
+
+    const auto numChannels = (int) reader->numChannels;
+    const auto sampleRate = reader->sampleRate;
+    const auto length = reader->lengthInSamples;
+    if (numChannels <= 0 || sampleRate <= 0.0 || length <= 0)
+    {
+        result.detail = "empty file";
+        return result;
+    }
+
+    auto layout = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    if (layout.size() != numChannels)
+        layout = juce::AudioChannelSet::discreteChannels(numChannels);
+
+    FrameAnalyzer analyzer;
+    analyzer.prepare(sampleRate, layout);
+
+    // Size the timeline (and pyramid) to the file: every point fits, and a short
+    // file does not reserve a 6 h chunk table and pyramid.
+    TimelineStore::Config timelineConfig;
+    timelineConfig.maxSessionSec = (double) length / sampleRate + 1.0;
+
+    SpectralAnalyzer::Config spectralConfig;
+    spectralConfig.enabled = options.spectral;
+    spectralConfig.cpuBudgetFraction = 0.0;
+
+    FeatureCollector collector(FeatureCollector::Threading::inlineOnly);
+    collector.setTimelineConfig(timelineConfig);
+    collector.setSpectralConfig(spectralConfig);
+    collector.prepare(sampleRate, options.blockSize, numChannels);
+
+    juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+
+    for (juce::int64 pos = 0; pos < length;)
+    {
+        const auto n = (int) juce::jmin<juce::int64>(options.blockSize, length - pos);
+        if (! reader->read(&buffer, 0, n, pos, true, true))
+        {
+            result.detail = "read error at sample " + juce::String(pos);
+            return result;
+        }
+
+        const auto* const* channels = buffer.getArrayOfReadPointers();
+        const auto frame = analyzer.analyse(channels, numChannels, n, (double) pos / sampleRate);
+        collector.ingestSamples(channels, numChannels, n);
+        collector.ingestFrames(&frame, 1);
+        pos += n;
+    }
+
+    SnapshotRequest request;
+    request.trackId = job.trackId;
+    request.sessionId = options.sessionId;
+    request.hostName = "ma_probe_batch";
+    request.dataRootOverride = options.dataRoot;
+    request.buildId = kBuildId;
+    request.sampleRate = sampleRate;
+    request.writeColumnarTimeline = options.columnar;
+    request.pyramidLevels = options.pyramidLevels;
+
+    result.ok = collector.writeSnapshotNow(request);
+    result.detail = result.ok ? collector.getLastWritePath() : juce::String("could not write sidecar");
+    result.audioSec = (double) length / sampleRate;
+    result.wallSec = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    return result;
+}
+
+// Expands directories and gives every input a unique track_id (file stem, then
+// "<parent>_<stem>" on a clash) so parallel jobs never share a snapshot folder.
+std::vector<BatchJob> collectJobs(const juce::StringArray& paths, bool recursive)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    const auto wildcard = formats.getWildcardForAllFormats();
+
+    juce::Array<juce::File> files;
+    for (const auto& path : paths)
+    {
+        const juce::File item = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+        if (item.isDirectory())
+        {
+            auto found = item.findChildFiles(juce::File::findFiles, recursive, wildcard);
+            found.sort();
+            files.addArray(found);
+        }
+        else
+        {
+            files.add(item);
+        }
+    }
+
+    std::vector<BatchJob> jobs;
+    std::set<juce::String> usedIds;
+    for (const auto& file : files)
+    {
+        auto trackId = file.getFileNameWithoutExtension();
+        if (usedIds.count(trackId) > 0)
+            trackId = file.getParentDirectory().getFileName() + "_" + trackId;
+        for (int suffix = 2; usedIds.count(trackId) > 0; ++suffix)
+            trackId = file.getFileNameWithoutExtension() + "_" + juce::String(suffix);
+        usedIds.insert(trackId);
+        jobs.push_back({ file, trackId });
+    }
+    return jobs;
+}
+
+void printUsage()
+{
+    std::fprintf(stderr,
+                 "usage: ma_probe_batch [--out DIR] [--session ID] [--jobs N] [--block N]\n"
+                 "                      [--recursive] [--columnar] [--pyramid LIST] [--spectral]\n"
+                 "                      <file-or-directory>...\n");
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BatchOptions options;
+    int numThreads = juce::SystemStats::getNumCpus();
+    bool recursive = false;
+    juce::StringArray inputs;
+
+    // Options take "--name value" or "--name=value"; anything else is an input path.
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        juce::String value;
+        if (arg.startsWith("--") && arg.contains("="))
+        {
+            value = arg.fromFirstOccurrenceOf("=", false, false);
+            arg = arg.upToFirstOccurrenceOf("=", false, false);
+        }
+
+        const auto takeValue = [&]
+        {
+            if (value.isEmpty() && i + 1 < argc)
+                value = juce::CharPointer_UTF8(argv[++i]);
+            return value;
+        };
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--out")
+            options.dataRoot = juce::File::getCurrentWorkingDirectory().getChildFile(takeValue()).getFullPathName();
+        else if (arg == "--session")
+            options.sessionId = takeValue();
+        else if (arg == "--jobs")
+            numThreads = juce::jmax(1, takeValue().getIntValue());
+        else if (arg == "--block")
+            options.blockSize = juce::jlimit(32, 65536, takeValue().getIntValue());
+        else if (arg == "--recursive")
+            recursive = true;
+        else if (arg == "--columnar")
+            options.columnar = true;
+        else if (arg == "--pyramid")
+            options.pyramidLevels = SidecarSchema::parsePyramidLevels(takeValue());
+        else if (arg == "--spectral")
+            options.spectral = true;
+        else if (arg.startsWith("-"))
+        {
+            std::fprintf(stderr, "ma_probe_batch: unknown option %s\n", arg.toRawUTF8());
+            printUsage();
+            return 2;
+        }
+        else
+            inputs.add(arg);
+    }
+
+    if (options.sessionId.isEmpty())
+        options.sessionId = "batch";
+
+    const auto jobs = collectJobs(inputs, recursive);
+    if (jobs.empty())
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<BatchResult> results(jobs.size());
+    std::mutex printMutex;
+    std::atomic<int> remaining{(int) jobs.size()};
+    juce::WaitableEvent allDone;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool(juce::jmin(numThreads, (int) jobs.size()));
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            pool.addJob([&, i]
+            {
+                results[i] = analyseFile(jobs[i], options);
+                const auto& r = results[i];
+                {
+                    const std::lock_guard<std::mutex> lock(printMutex);
+                    std::printf("%s\t%s\t%s\t%.3f\t%.1fx\n",
+                                r.ok ? "ok" : "fail",
+                                jobs[i].input.getFullPathName().toRawUTF8(),
+                                r.detail.toRawUTF8(),
+                                r.audioSec,
+                                r.wallSec > 0.0 ? r.audioSec / r.wallSec : 0.0);
+                    std::fflush(stdout);
+                }
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+        allDone.wait();
+    }
+
+    int failures = 0;
+    double totalAudioSec = 0.0;
+    for (const auto& r : results)
+    {
+        failures += r.ok ? 0 : 1;
+        totalAudioSec += r.audioSec;
+    }
+    const auto wallSec = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    std::fprintf(stderr, "ma_probe_batch: %d file(s), %d failed, %.1f s of audio in %.1f s (%.1fx real time, %d threads)\n",
+                 (int) jobs.size(), failures, totalAudioSec, wallSec,
+                 wallSec > 0.0 ? totalAudioSec / wallSec : 0.0, juce::jmin(numThreads, (int) jobs.size()));
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+// ma_probe_bench: microbenchmarks for the probe's DSP/IO hot paths, linked
+// against the same core sources as the plugin (no plugin wrapper, no host).
+//
+//   ma_probe_bench [--quick] [--filter <substring>]
+//     --quick            shorter sessions (1 and 10 minutes) for a smoke run
+//     --filter <s>       only run cases whose name contains <s>
+//
+// Prints one JSON object per case on stdout (see ma/bench/Bench.h). Cases:
+//   frame_analyse       FrameAnalyzer::analyse (the plugin's makeFrame), 32..4096
+//                       sample blocks x mono..7.1.4
+//   collector_ingest    FeatureCollector frame aggregation over 1 min .. 4 h sessions
+//   write_snapshot      JSON (+ columnar) sidecar write for those sessions
+//   spectral_ingest     mono mixdown + STFT stage per 512-sample stereo block
+//   raw_tap_wrap        RawSampleTap round trip across many ring wraps; a check,
+//                       not a timing: exits 1 if any sample comes back wrong
+//   instantiate         FeatureCollector construct + destroy, as during a plugin scan
+//   prepare_release     prepare (FIFO, 6 h timeline table, writer thread) + release
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <ma/bench/Bench.h>
+
+#include "../dsp/FeatureCollector.h"
+#include "../dsp/FrameAnalyzer.h"
+#include "../dsp/RawSampleTap.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+constexpr double kSampleRate = 48000.0;
+constexpr int kSessionBlock = 512;
+// Per-instance budget for a host scan / project open (construct + destroy).
+constexpr double kInstantiateBudgetUs = 1000.0;
+
+struct Layout
+{
+    const char* name;
+    juce::AudioChannelSet set;
+};
+
+std::vector<Layout> benchLayouts()
+{
+    return { { "mono", juce::AudioChannelSet::mono() },
+             { "stereo", juce::AudioChannelSet::stereo() },
+             { "5.1", juce::AudioChannelSet::create5point1() },
+             { "7.1", juce::AudioChannelSet::create7point1() },
+             { "7.1.4", juce::AudioChannelSet::create7point1point4() } };
+}
+
+// Deterministic, non-trivial programme material (so filters and peak paths do real work).
+juce::AudioBuffer<float> makeSignal(int numChannels, int numSamples)
+{
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    juce::Random random(1234);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = buffer.getWritePointer(ch);
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = 0.5f * std::sin(0.013f * (float) (i * (ch + 1))) + 0.1f * (random.nextFloat() - 0.5f);
+    }
+    return buffer;
+}
+
+// Percentage of one core needed to keep up with real time at kSampleRate.
+double realtimeCpuPercent(double nsPerBlock, int blockSize)
+{
+    return 100.0 * nsPerBlock / ((double) blockSize / kSampleRate * 1.0e9);
+}
+
+struct BenchOptions
+{
+    bool quick{false};
+    juce::String filter;
+    bool wants(const char* caseName) const { return filter.isEmpty() || juce::String(caseName).contains(filter); }
+};
+
+void benchFrameAnalyse(const ma::bench::Reporter& reporter)
+{
+    for (const auto& layout : benchLayouts())
+    {
+        const int numChannels = layout.set.size();
+        for (int block = 32; block <= 4096; block *= 2)
+        {
+            FrameAnalyzer analyzer;
+            analyzer.prepare(kSampleRate, layout.set);
+            const auto signal = makeSignal(numChannels, block);
+            const auto* const* channels = signal.getArrayOfReadPointers();
+            double t = 0.0;
+            volatile double sink = 0.0;
+
+            const auto r = ma::bench::measure([&]
+            {
+                const auto frame = analyzer.analyse(channels, numChannels, block, t);
+                sink = sink + frame.sumSquares;
+                t += (double) block / kSampleRate;
+            });
+            reporter.report("frame_analyse:" + std::string(layout.name),
+                            { { "block", block }, { "channels", numChannels } }, r,
+                            { { "ns_per_sample", r.nsPerIteration / (double) (block * numChannels) },
+                              { "rt_cpu_pct", realtimeCpuPercent(r.nsPerIteration, block) } });
+        }
+    }
+}
+
+ProbeFrame syntheticFrame(int64_t index, int numChannels)
+{
+    ProbeFrame frame;
+    frame.timestampSec = (double) index * kSessionBlock / kSampleRate;
+    frame.samplesPerChannel = kSessionBlock;
+    frame.sampleCount = kSessionBlock * numChannels;
+    const auto level = 0.05 + 0.04 * std::sin((double) index * 0.001);
+    frame.sumSquares = level * level * frame.sampleCount;
+    frame.kWeightedEnergy = frame.sumSquares * 0.9;
+    frame.peakLinear = (float) (level * 2.5);
+    frame.truePeakLinear = frame.peakLinear * 1.02f;
+    return frame;
+}
+
+void benchSessions(const ma::bench::Reporter& reporter, const BenchOptions& options, const juce::File& scratch)
+{
+    std::vector<double> sessionsMin = options.quick ? std::vector<double>{ 1.0, 10.0 }
+                                                    : std::vector<double>{ 1.0, 10.0, 60.0, 240.0 };
+    constexpr int numChannels = 2;
+    for (const auto minutes : sessionsMin)
+    {
+        const auto seconds = minutes * 60.0;
+        const auto numFrames = (int64_t) std::ceil(seconds * kSampleRate / kSessionBlock);
+
+        TimelineStore::Config timelineConfig;
+        timelineConfig.maxSessionSec = seconds + 1.0;
+        FeatureCollector collector(FeatureCollector::Threading::inlineOnly);
+        collector.setTimelineConfig(timelineConfig);
+        collector.prepare(kSampleRate, kSessionBlock, numChannels);
+
+        const auto ingest = ma::bench::measureOnce([&]
+        {
+            for (int64_t i = 0; i < numFrames; ++i)
+            {
+                const auto frame = syntheticFrame(i, numChannels);
+                collector.ingestFrames(&frame, 1);
+            }
+        });
+        if (options.wants("collector_ingest"))
+            reporter.report("collector_ingest", { { "session_min", minutes }, { "frames", (double) numFrames } }, ingest,
+                            { { "ns_per_frame", ingest.nsPerIteration / (double) numFrames } });
+
+        if (! options.wants("write_snapshot"))
+            continue;
+
+        for (const bool columnar : { false, true })
+        {
+            SnapshotRequest request;
+            request.trackId = "bench_" + juce::String((int) minutes) + "min" + (columnar ? "_columnar" : "");
+            request.sessionId = "bench";
+            request.hostName = "ma_probe_bench";
+            request.dataRootOverride = scratch.getFullPathName();
+            request.sampleRate = kSampleRate;
+            request.writeColumnarTimeline = columnar;
+
+            bool ok = false;
+            const auto write = ma::bench::measureOnce([&] { ok = collector.writeSnapshotNow(request); });
+            const auto folder = juce::File(collector.getLastWritePath()).getParentDirectory();
+            juce::int64 bytes = 0;
+            for (const auto& file : folder.findChildFiles(juce::File::findFiles, false))
+                bytes += file.getSize();
+            reporter.report(columnar ? "write_snapshot:columnar" : "write_snapshot:json",
+                            { { "session_min", minutes }, { "frames", (double) numFrames } }, write,
+                            { { "ok", ok ? 1.0 : 0.0 }, { "bytes", (double) bytes } });
+        }
+    }
+}
+
+void benchSpectral(const ma::bench::Reporter& reporter)
+{
+    constexpr int numChannels = 2;
+    SpectralAnalyzer::Config spectralConfig;
+    spectralConfig.enabled = true;
+    spectralConfig.cpuBudgetFraction = 0.0;
+
+    FeatureCollector collector(FeatureCollector::Threading::inlineOnly);
+    collector.setSpectralConfig(spectralConfig);
+    collector.prepare(kSampleRate, kSessionBlock, numChannels);
+
+    const auto signal = makeSignal(numChannels, kSessionBlock);
+    const auto* const* channels = signal.getArrayOfReadPointers();
+    const auto r = ma::bench::measure([&] { collector.ingestSamples(channels, numChannels, kSessionBlock); });
+    reporter.report("spectral_ingest", { { "block", kSessionBlock }, { "channels", numChannels } }, r,
+                    { { "rt_cpu_pct", realtimeCpuPercent(r.nsPerIteration, kSessionBlock) } });
+}
+// Odd-sized blocks through a small multi-channel tap, drained in uneven steps,
+// so writes and reads straddle the wrap point (including the FIFO's last
+// index). Every sample encodes its channel and position; returns the number
+// that came back wrong.
+int64_t checkRawTapWrap(const ma::bench::Reporter& reporter)
+{
+    constexpr int numChannels = 3;
+    constexpr int blockSize = 97;
+    constexpr int numBlocks = 400;
+
+    RawSampleTap tap;
+    tap.prepare(true, 8000.0, blockSize, numChannels, 0.05);
+
+    const auto expected = [](int ch, int64_t n) { return (float) (ch * 1000000 + n); };
+    std::vector<float> block((size_t) numChannels * blockSize);
+    std::array<const float*, numChannels> channels{};
+    int64_t written = 0;
+    int64_t consumed = 0;
+    int64_t mismatches = 0;
+
+    const auto r = ma::bench::measureOnce([&]
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* dest = block.data() + (size_t) ch * blockSize;
+                for (int i = 0; i < blockSize; ++i)
+                    dest[i] = expected(ch, written + i);
+                channels[(size_t) ch] = dest;
+            }
+            if (tap.write(channels.data(), numChannels, blockSize) == 0)
+                written += blockSize;
+
+            // Drain on a different rhythm from the writes, so the read spans wrap
+            // at different offsets.
+            if (b % 7 == 6 || b == numBlocks - 1)
+            {
+                tap.read([&](const float* const* spans, int spanChannels, int numSamples)
+                {
+                    for (int ch = 0; ch < spanChannels; ++ch)
+                        for (int i = 0; i < numSamples; ++i)
+                            mismatches += spans[ch][i] != expected(ch, consumed + i) ? 1 : 0;
+                    consumed += numSamples;
+                });
+            }
+        }
+    });
+    mismatches += consumed != written ? 1 : 0;
+
+    reporter.report("raw_tap_wrap", { { "channels", numChannels }, { "capacity", tap.getCapacity() } }, r,
+                    { { "samples", (double) consumed },
+                      { "overruns", (double) tap.getOverrunEvents() },
+                      { "mismatches", (double) mismatches } });
+    return mismatches;
+}
+
+void benchLifecycle(const ma::bench::Reporter& reporter, const BenchOptions& options)
+{
+    if (options.wants("instantiate"))
+    {
+        const auto r = ma::bench::measure([] { FeatureCollector collector; });
+        const auto us = r.nsPerIteration / 1000.0;
+        reporter.report("instantiate", {}, r,
+                        { { "us_per_instance", us },
+                          { "budget_us", kInstantiateBudgetUs },
+                          { "within_budget", us <= kInstantiateBudgetUs ? 1.0 : 0.0 } });
+    }
+    if (options.wants("prepare_release"))
+    {
+        // The only active instance, so each cycle also starts and stops the writer thread.
+        FeatureCollector collector;
+        const auto r = ma::bench::measure([&]
+        {
+            collector.prepare(kSampleRate, kSessionBlock, 2);
+            collector.release();
+        });
+        reporter.report("prepare_release", { { "block", kSessionBlock } }, r,
+                        { { "us_per_cycle", r.nsPerIteration / 1000.0 } });
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        if (arg == "--quick")
+            options.quick = true;
+        else if (arg == "--filter" && i + 1 < argc)
+            options.filter = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: ma_probe_bench [--quick] [--filter <substring>]\n");
+            return 2;
+        }
+    }
+
+    const ma::bench::Reporter reporter("juce_probe");
+    const auto scratch = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                             .getNonexistentChildFile("ma_probe_bench", {}, false);
+    scratch.createDirectory();
+
+    if (options.wants("frame_analyse"))
+        benchFrameAnalyse(reporter);
+    if (options.wants("collector_ingest") || options.wants("write_snapshot"))
+        benchSessions(reporter, options, scratch);
+    if (options.wants("spectral_ingest"))
+        benchSpectral(reporter);
+    const auto tapMismatches = options.wants("raw_tap_wrap") ? checkRawTapWrap(reporter) : 0;
+    benchLifecycle(reporter, options);
+
+    scratch.deleteRecursively();
+    return tapMismatches == 0 ? 0 : 1;
+}
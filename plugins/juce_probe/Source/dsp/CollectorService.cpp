@@ -0,0 +1,162 @@
+#include "CollectorService.h"
+
+#include <algorithm>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <climits>
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <ctime>
+ #include <semaphore.h>
+#endif
+
+// juce::Thread::notify() takes a lock, so the audio thread cannot use it. These
+// posts are lock-free in user space (at worst one syscall to wake the waiter).
+class CollectorService::WakeSemaphore
+{
+public:
+#if JUCE_MAC || JUCE_IOS
+    WakeSemaphore() : sem(dispatch_semaphore_create(0)) {}
+    ~WakeSemaphore() { dispatch_release(sem); }
+    void post() noexcept { dispatch_semaphore_signal(sem); }
+    void waitFor(int ms) noexcept
+    {
+        dispatch_semaphore_wait(sem, dispatch_time(DISPATCH_TIME_NOW, (int64_t) ms * NSEC_PER_MSEC));
+    }
+
+private:
+    dispatch_semaphore_t sem;
+#elif JUCE_WINDOWS
+    WakeSemaphore() : sem(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+    ~WakeSemaphore() { CloseHandle(sem); }
+    void post() noexcept { ReleaseSemaphore(sem, 1, nullptr); }
+    void waitFor(int ms) noexcept { WaitForSingleObject(sem, (DWORD) ms); }
+
+private:
+    HANDLE sem;
+#else
+    WakeSemaphore() { sem_init(&sem, 0, 0); }
+    ~WakeSemaphore() { sem_destroy(&sem); }
+    void post() noexcept { sem_post(&sem); } // async-signal-safe
+    void waitFor(int ms) noexcept
+    {
+        timespec deadline{};
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += ms / 1000;
+        deadline.tv_nsec += (long) (ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (sem_timedwait(&sem, &deadline) != 0 && errno == EINTR) {}
+    }
+
+private:
+    sem_t sem;
+#endif
+};
+
+CollectorService::CollectorService()
+    : juce::Thread("MAProbeCollector"),
+      wakeSignal(std::make_unique<WakeSemaphore>())
+{
+}
+
+CollectorService::~CollectorService()
+{
+    stopWriter();
+}
+
+void CollectorService::stopWriter()
+{
+    // run() sleeps on the semaphore, not juce::Thread::wait(), so stopThread()'s
+    // own notify() would not reach it.
+    signalThreadShouldExit();
+    wakeSignal->post();
+    stopThread(kStopTimeoutMs);
+}
+
+void CollectorService::registerClient(Client& client)
+{
+    const std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+    {
+        const std::lock_guard<std::mutex> lock(clientsMutex);
+        if (std::find(clients.begin(), clients.end(), &client) == clients.end())
+            clients.push_back(&client);
+    }
+
+    if (! isThreadRunning())
+        startThread();
+    wake();
+}
+
+void CollectorService::unregisterClient(Client& client)
+{
+    const std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+    bool idle = false;
+    {
+        std::unique_lock<std::mutex> lock(clientsMutex);
+        clients.erase(std::remove(clients.begin(), clients.end(), &client), clients.end());
+        // The pass skips clients that are no longer listed; wait out the one in flight.
+        serviceDone.wait(lock, [this, &client] { return inService != &client; });
+        idle = clients.empty();
+    }
+
+    if (idle)
+        stopWriter();
+}
+
+void CollectorService::wake() noexcept
+{
+    // Only the first caller per pass posts; later ones pay one atomic exchange.
+    if (! wakePending.exchange(true, std::memory_order_acq_rel))
+        wakeSignal->post();
+}
+
+bool CollectorService::servicePass()
+{
+    {
+        const std::lock_guard<std::mutex> lock(clientsMutex);
+        passClients.assign(clients.begin(), clients.end());
+    }
+
+    bool anyWork = false;
+    for (auto* client : passClients)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(clientsMutex);
+            if (std::find(clients.begin(), clients.end(), client) == clients.end())
+                continue; // unregistered since the snapshot
+            inService = client;
+        }
+
+        anyWork = client->serviceCollector() || anyWork;
+
+        {
+            const std::lock_guard<std::mutex> lock(clientsMutex);
+            inService = nullptr;
+        }
+        serviceDone.notify_all();
+    }
+    return anyWork;
+}
+
+void CollectorService::run()
+{
+    int waitMs = kBusyWaitMs;
+    while (! threadShouldExit())
+    {
+        wakePending.store(false, std::memory_order_release);
+        waitMs = servicePass() ? kBusyWaitMs : std::min(waitMs * 2, kMaxIdleWaitMs);
+        // A wake posted during the pass makes this return at once.
+        if (! threadShouldExit())
+            wakeSignal->waitFor(waitMs);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Process-wide writer thread shared by every FeatureCollector (hold it through
+// juce::SharedResourcePointer). One pass drains every registered instance. The
+// thread blocks on a kernel semaphore until a client wakes it (FIFO high-water
+// mark, snapshot or live-capture request) or its adaptive timeout expires:
+// short while there is work, doubling up to kMaxIdleWaitMs when every instance
+// is idle (capture off, transport stopped), so an idle process wakes twice a
+// second however many instances it hosts.
+// Clients are serviced outside the client-list lock, so one instance's disk
+// I/O never blocks another's register/unregister.
+class CollectorService : private juce::Thread
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+        // Writer thread. Returns true if the pass found work (frames, snapshot, ...).
+        virtual bool serviceCollector() = 0;
+    };
+
+    CollectorService();
+    ~CollectorService() override;
+
+    // Message thread. The thread starts with the first client and stops when the
+    // last one leaves (every instance released), so instances that are only
+    // scanned or loaded but never prepared cost no thread. unregisterClient
+    // blocks until an in-flight pass has finished with that client.
+    void registerClient(Client& client);
+    void unregisterClient(Client& client);
+
+    // Any thread, including audio: one atomic exchange, plus at most one
+    // semaphore post per pass (no locks, no allocation).
+    void wake() noexcept;
+
+    static constexpr int kBusyWaitMs = 25;
+    static constexpr int kMaxIdleWaitMs = 500;
+
+private:
+    class WakeSemaphore; // platform semaphore whose post is real-time safe
+
+    void run() override;
+    bool servicePass();
+    void stopWriter();
+
+    static constexpr int kStopTimeoutMs = 2000;
+
+    std::mutex lifecycleMutex; // serialises thread start/stop
+    std::mutex clientsMutex;
+    std::condition_variable serviceDone;  // signalled when inService is cleared
+    std::vector<Client*> clients;         // guarded by clientsMutex
+    Client* inService{nullptr};           // guarded by clientsMutex
+    std::vector<Client*> passClients;     // writer thread: this pass's snapshot of `clients`
+    std::unique_ptr<WakeSemaphore> wakeSignal;
+    std::atomic<bool> wakePending{false};
+};
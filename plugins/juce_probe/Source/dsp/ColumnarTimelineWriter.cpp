@@ -0,0 +1,99 @@
+#include "ColumnarTimelineWriter.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr int kHeaderBytes = 64;
+constexpr int kEntryBytes = 64;
+constexpr int kVersionBytes = 32;
+constexpr int kNameBytes = 40;
+
+juce::uint64 alignUp(juce::uint64 value)
+{
+    const auto a = (juce::uint64) ColumnarTimeline::kAlignment;
+    return (value + a - 1) / a * a;
+}
+
+void writeFixedString(juce::OutputStream& out, const juce::String& text, int width)
+{
+    char buffer[64] = {};
+    jassert(width <= (int) sizeof(buffer));
+    text.copyToUTF8(buffer, (size_t) width); // always NUL terminated within `width`
+    out.write(buffer, (size_t) width);
+}
+
+template <int Band>
+float octaveBandDb(const TimelinePoint& p)
+{
+    return p.spectral.octaveBandDb[(size_t) Band];
+}
+} // namespace
+
+namespace ColumnarTimeline
+{
+const std::vector<Column>& columns()
+{
+    static const std::vector<Column> cols{
+        { "time_sec", [](const TimelinePoint& p) { return (float) p.timeSec; } },
+        { "rms_db", [](const TimelinePoint& p) { return p.rmsDb; } },
+        { "peak_db", [](const TimelinePoint& p) { return p.peakDb; } },
+        { "momentary_lufs", [](const TimelinePoint& p) { return p.momentaryLufs; } },
+        { "short_term_lufs", [](const TimelinePoint& p) { return p.shortTermLufs; } },
+        // Spectral columns are NaN unless MA_PROBE_SPECTRAL is on.
+        { "spectral_centroid_hz", [](const TimelinePoint& p) { return p.spectral.centroidHz; } },
+        { "spectral_rolloff_hz", [](const TimelinePoint& p) { return p.spectral.rolloffHz; } },
+        { "spectral_flux", [](const TimelinePoint& p) { return p.spectral.flux; } },
+        { "octave_band_31_db", octaveBandDb<0> },
+        { "octave_band_63_db", octaveBandDb<1> },
+        { "octave_band_125_db", octaveBandDb<2> },
+        { "octave_band_250_db", octaveBandDb<3> },
+        { "octave_band_500_db", octaveBandDb<4> },
+        { "octave_band_1k_db", octaveBandDb<5> },
+        { "octave_band_2k_db", octaveBandDb<6> },
+        { "octave_band_4k_db", octaveBandDb<7> },
+        { "octave_band_8k_db", octaveBandDb<8> },
+        { "octave_band_16k_db", octaveBandDb<9> },
+        { "tempo_bpm", [](const TimelinePoint& p) { return p.tempoBpm; } },
+    };
+    return cols;
+}
+
+void write(juce::OutputStream& out,
+           const TimelineStore& timeline,
+           const juce::String& versionTag,
+           double sampleRate)
+{
+    const auto& cols = columns();
+    const auto numRows = (juce::uint64) timeline.size();
+    const auto columnBytes = numRows * sizeof(float);
+    const auto headerBytes = alignUp((juce::uint64) (kHeaderBytes + kEntryBytes * (int) cols.size()));
+
+    out.write(kMagic, 8);
+    writeFixedString(out, versionTag, kVersionBytes);
+    out.writeInt((int) headerBytes);
+    out.writeInt((int) cols.size());
+    out.writeInt64((juce::int64) numRows);
+    out.writeDouble(sampleRate);
+
+    auto offset = headerBytes;
+    for (const auto& col : cols)
+    {
+        writeFixedString(out, col.name, kNameBytes);
+        out.writeInt((int) kDtypeFloat32);
+        out.writeInt(0);
+        out.writeInt64((juce::int64) offset);
+        out.writeInt64((juce::int64) columnBytes);
+        offset = alignUp(offset + columnBytes);
+    }
+    out.writeRepeatedByte(0, (size_t) (headerBytes - (juce::uint64) (kHeaderBytes + kEntryBytes * (int) cols.size())));
+
+    for (const auto& col : cols)
+    {
+        timeline.forEach([&out, &col](const TimelinePoint& point) { out.writeFloat(col.read(point)); });
+        out.writeRepeatedByte(0, (size_t) (alignUp(columnBytes) - columnBytes));
+    }
+
+    out.flush();
+}
+} // namespace ColumnarTimeline
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <vector>
+
+#include "TimelineStore.h"
+
+// Binary columnar sidecar for the timeline (`juce_probe_timeline.bin`), laid out
+// for mmap / numpy.memmap. All integers and floats are little-endian.
+//
+//   [0, 64)     header: magic "MAPRCOLS", version tag (char[32], NUL padded,
+//               "juce_probe_features_v1"), uint32 header_bytes, uint32 num_columns,
+//               uint64 num_rows, float64 sample_rate
+//   [64, ...)   num_columns x 64-byte directory entries: char name[40], uint32 dtype
+//               (1 = float32), uint32 reserved, uint64 offset, uint64 byte_length
+//   header_bytes onwards: one contiguous column per entry, each starting on a
+//               64-byte boundary
+//
+// New features are appended as new columns; readers look them up by name.
+namespace ColumnarTimeline
+{
+constexpr const char* kFileName = "juce_probe_timeline.bin";
+constexpr const char* kMagic = "MAPRCOLS";
+constexpr int kAlignment = 64;
+constexpr juce::uint32 kDtypeFloat32 = 1;
+
+struct Column
+{
+    const char* name;
+    float (*read)(const TimelinePoint&);
+};
+
+// Columns emitted today, in file order.
+const std::vector<Column>& columns();
+
+// Caller checks the stream status (e.g. FileOutputStream::getStatus) afterwards.
+void write(juce::OutputStream& out,
+           const TimelineStore& timeline,
+           const juce::String& versionTag,
+           double sampleRate);
+} // namespace ColumnarTimeline
@@ -1,12 +1,18 @@
 #include "FeatureCollector.h"
+#include "ColumnarTimelineWriter.h"
+#include "JsonStreamWriter.h"
+#include "SidecarSchema.h"
 
-#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <ma/index/SidecarIndex.h>
+#include <algorithm>
 #include <cstdlib>
 
 namespace
 {
 constexpr double kTimelineSpacingSec = 0.25; // downsampled envelope for the sidecar
 constexpr double kEpsilon = 1.0e-9;
+constexpr size_t kSidecarWriteBufferBytes = 1 << 16;
 
 juce::String sanitiseId(const juce::String& raw)
 {
@@ -32,46 +38,350 @@ juce::File resolveDataRoot(const SnapshotRequest& req)
         return juce::File(req.dataRootOverride).getAbsoluteFile();
     return defaultDataRoot();
 }
+
+juce::File resolveTrackFolder(const SnapshotRequest& req)
+{
+    return resolveDataRoot(req).getChildFile("features_output")
+                               .getChildFile("juce_probe")
+                               .getChildFile(sanitiseId(req.trackId));
+}
 } // namespace
 
-FeatureCollector::FeatureCollector()
-    : juce::Thread("FeatureCollectorWriter"), fifo(fifoCapacity)
+FeatureCollector::FeatureCollector(Threading threadingMode)
+    : threading(threadingMode),
+      fifo(fifoCapacity)
 {
-    fifoBuffer.resize((size_t) fifoCapacity);
+    // Hosts construct many instances to scan or load a project that are never
+    // prepared, so the FIFO storage, analysis buffers, FFT and the shared
+    // writer are all left to prepare().
+    aggregator.spectral.setHopListener(&aggregator.tempo);
     aggregator.reset();
-    startThread();
 }
 
 FeatureCollector::~FeatureCollector()
 {
-    stopThread(2000);
+    release();
 }
 
-void FeatureCollector::prepare(double sampleRate, int maxBlockSize)
+void FeatureCollector::prepare(double sampleRate, int maxBlockSize, int numChannels)
 {
-    juce::ignoreUnused(maxBlockSize);
+    // Re-preparing a running instance: take it off the writer thread first, so
+    // the pass never sees half-configured state. Live capture carries on (its
+    // file gets a "reset" row).
+    leaveService();
+
+    fifoBuffer.resize((size_t) fifoCapacity);
     aggregator.sampleRate = sampleRate;
-    aggregator.reset();
+    aggregator.loudness.prepare(sampleRate);
+    aggregator.spectral.prepare(sampleRate, spectralConfig);
+    aggregator.tempo.prepare(aggregator.spectral.getHopSeconds());
+    aggregator.timeline.prepare(timelineConfig, kTimelineSpacingSec, sampleRate, maxBlockSize, spectralConfig.enabled);
+    {
+        const std::lock_guard<std::mutex> lock(pyramidMutex);
+        aggregator.pyramid.prepare(timelineConfig.maxSessionSec, timelineConfig.ringWindowSec);
+        aggregator.reset();
+    }
     fifo.reset();
+    droppedFrames.store(0, std::memory_order_relaxed);
+    telemetry.reset();
+
+    // Off unless a stage needs raw samples, so the base probe pays nothing.
+    const bool needsSamples = spectralConfig.enabled;
+    sampleTap.prepare(needsSamples && threading == Threading::sharedService,
+                      sampleRate, maxBlockSize, numChannels);
+    mixBuffer.resize(needsSamples ? (size_t) kMixChunk : 0);
+    aggregator.spectral.setBudgetEnabled(! nonRealtime.load());
+
+    // Offline renders aggregate on the render thread and stay off the service.
+    if (! nonRealtime.load())
+        joinService();
+}
+
+void FeatureCollector::joinService()
+{
+    // The service only starts its thread for the first registered client.
+    if (threading != Threading::sharedService || fifoBuffer.empty())
+        return;
+    if (! service.has_value())
+        service.emplace();
+    if (! serviceRegistered.exchange(true))
+        (*service)->registerClient(*this);
+}
+
+void FeatureCollector::leaveService()
+{
+    // Blocks until the writer's in-flight pass is done; from here on the
+    // calling thread owns the writer-side state.
+    if (serviceRegistered.exchange(false))
+        (*service)->unregisterClient(*this);
+}
+
+void FeatureCollector::wakeService()
+{
+    // Any thread; `service` is set before serviceRegistered and never reset.
+    if (serviceRegistered.load(std::memory_order_acquire))
+        (*service)->wake();
+}
+
+void FeatureCollector::release()
+{
+    leaveService();
+    // Whatever is still queued belongs in the live capture's final flush.
+    drainSamples();
+    drainFrames();
+    if (liveWriter.isOpen())
+        liveWriter.close(aggregator.timeline, aggregator.globalFeatures());
+    liveBus.close();
+    liveBusFailed = false;
+    liveBusIdentityChanged.store(true);
+    liveCommand.store(LiveCommand::none);
+    liveCapturing.store(false);
+    snapshotRequested.store(false);
+
+    {
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        livePath.clear();
+        liveBusSegmentName.clear();
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(pyramidMutex);
+        aggregator.reset();
+        aggregator.pyramid.release();
+    }
+    aggregator.spectral.release();
+    aggregator.timeline.release();
+    fifo.reset();
+    std::vector<ProbeFrame>().swap(fifoBuffer);
+    sampleTap.prepare(false, aggregator.sampleRate, 0, 0);
+    std::vector<float>().swap(mixBuffer);
+    lastWritePath.clear();
+}
+
+void FeatureCollector::setNonRealtime(bool shouldBeNonRealtime)
+{
+    if (threading != Threading::sharedService)
+        return;
+
+    const std::lock_guard<std::mutex> lock(offlineMutex);
+    if (nonRealtime.load() == shouldBeNonRealtime)
+        return;
+
+    if (shouldBeNonRealtime)
+    {
+        // The writer thread is done with this instance once this returns, so the
+        // render thread can own the aggregator. A bounce is its own session.
+        leaveService();
+        {
+            const std::lock_guard<std::mutex> pyramidLock(pyramidMutex);
+            aggregator.reset();
+        }
+        fifo.reset();
+        sampleTap.reset();
+        offlineFrames = 0;
+        // serviceInline() runs on the render clock, which starts at zero.
+        lastLiveFlushMs = 0.0;
+        inlineBusDueSec = 0.0;
+    }
+    else
+    {
+        lastLiveFlushMs = juce::Time::getMillisecondCounterHiRes();
+    }
+    aggregator.spectral.setBudgetEnabled(! shouldBeNonRealtime);
+    nonRealtime.store(shouldBeNonRealtime, std::memory_order_release);
+    if (! shouldBeNonRealtime)
+        joinService();
+}
+
+bool FeatureCollector::writeOfflineSnapshot(const SnapshotRequest& request)
+{
+    const std::lock_guard<std::mutex> lock(offlineMutex);
+    if (! nonRealtime.load() || offlineFrames == 0)
+        return false;
+
+    offlineFrames = 0;
+    aggregator.closeTimelineInterval();
+    writingSnapshot.store(true);
+    bool ok = false;
+    try
+    {
+        ok = writeSnapshot(request);
+    }
+    catch (const std::exception& e)
+    {
+        juce::Logger::writeToLog("MAProbe: offline sidecar failed: " + juce::String(e.what()));
+    }
+    writingSnapshot.store(false);
+    return ok;
+}
+
+bool FeatureCollector::queueOfflineSnapshot(const SnapshotRequest& request)
+{
+    const std::lock_guard<std::mutex> lock(offlineMutex);
+    if (! nonRealtime.load() || offlineFrames == 0)
+        return false;
+
+    offlineFrames = 0;
+    aggregator.closeTimelineInterval();
+    {
+        const std::lock_guard<std::mutex> requestLock(requestMutex);
+        pendingSnapshot = request;
+    }
+    // No wake: the writer is not ours until setNonRealtime(false) rejoins it,
+    // and joining wakes it.
+    snapshotRequested.store(true);
+    return true;
+}
+
+void FeatureCollector::setSpectralConfig(const SpectralAnalyzer::Config& config)
+{
+    spectralConfig = config;
+}
+
+void FeatureCollector::setLiveBusEnabled(bool enabled)
+{
+    liveBusEnabled = enabled && threading == Threading::sharedService;
+}
+
+void FeatureCollector::setLiveBusIdentity(const juce::String& trackId, const juce::String& sessionId)
+{
+    {
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        liveBusTrackId = trackId;
+        liveBusSessionId = sessionId;
+    }
+    liveBusIdentityChanged.store(true);
+}
+
+void FeatureCollector::setTimelineConfig(const TimelineStore::Config& config)
+{
+    timelineConfig = config;
 }
 
 void FeatureCollector::reset()
 {
-    aggregator.reset();
+    {
+        const std::lock_guard<std::mutex> lock(pyramidMutex);
+        aggregator.reset();
+    }
     fifo.reset();
+    sampleTap.reset();
     lastWritePath.clear();
 }
 
 void FeatureCollector::pushFrame(const ProbeFrame& frame)
 {
+    pushFrames(&frame, 1);
+}
+
+int FeatureCollector::pushFrames(const ProbeFrame* frames, int numFrames)
+{
+    if (frames == nullptr || numFrames <= 0)
+        return 0;
+    if (fifoBuffer.empty())
+        return numFrames; // not prepared (or released)
+
+    if (nonRealtime.load(std::memory_order_acquire))
+    {
+        // Offline render: the host waits for us, so aggregate here instead of
+        // racing the writer thread's poll.
+        const std::lock_guard<std::mutex> lock(offlineMutex);
+        ingestSpan(frames, numFrames);
+        offlineFrames += numFrames;
+        serviceInline();
+        return 0;
+    }
+
     int start1, size1, start2, size2;
-    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    fifo.prepareToWrite(numFrames, start1, size1, start2, size2);
     if (size1 > 0)
+        std::copy(frames, frames + size1, fifoBuffer.begin() + start1);
+    if (size2 > 0)
+        std::copy(frames + size1, frames + size1 + size2, fifoBuffer.begin() + start2);
+
+    const int written = size1 + size2;
+    if (written > 0)
+        fifo.finishedWrite(written);
+
+    const int numReady = fifo.getNumReady();
+    telemetry.recordFifoFill(numReady, fifoCapacity);
+    if (numReady >= fifoHighWater)
+        wakeService();
+
+    const int dropped = numFrames - written;
+    if (dropped > 0)
+        droppedFrames.store(droppedFrames.load(std::memory_order_relaxed) + dropped,
+                            std::memory_order_relaxed);
+    return dropped;
+}
+
+void FeatureCollector::pushSamples(const float* const* channels, int numChannels, int numSamples)
+{
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    if (nonRealtime.load(std::memory_order_acquire))
     {
-        fifoBuffer[(size_t) start1] = frame;
-        fifo.finishedWrite(size1);
+        const std::lock_guard<std::mutex> lock(offlineMutex);
+        analyseSamples(channels, numChannels, numSamples);
+        return;
     }
-    juce::ignoreUnused(start2, size2); // Single-region writes only.
+
+    if (! sampleTap.isEnabled())
+        return;
+
+    sampleTap.write(channels, numChannels, numSamples);
+    if (sampleTap.getNumReady() >= sampleTap.getCapacity() / 4)
+        wakeService();
+}
+
+void FeatureCollector::ingestSamples(const float* const* channels, int numChannels, int numSamples)
+{
+    jassert(threading == Threading::inlineOnly);
+    analyseSamples(channels, numChannels, numSamples);
+}
+
+// Aggregating thread: mono mixdown (chunked through mixBuffer) into the spectral stage.
+void FeatureCollector::analyseSamples(const float* const* channels, int numChannels, int numSamples)
+{
+    if (! spectralConfig.enabled || mixBuffer.empty() || numChannels <= 0)
+        return;
+
+    const float gain = 1.0f / (float) numChannels;
+    for (int offset = 0; offset < numSamples; offset += kMixChunk)
+    {
+        const int count = juce::jmin(kMixChunk, numSamples - offset);
+        auto* dest = mixBuffer.data();
+        juce::FloatVectorOperations::copyWithMultiply(dest, channels[0] + offset, gain, count);
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(dest, channels[ch] + offset, gain, count);
+        aggregator.spectral.process(dest, count);
+    }
+}
+
+void FeatureCollector::ingestFrames(const ProbeFrame* frames, int numFrames)
+{
+    jassert(threading == Threading::inlineOnly);
+    if (frames != nullptr && numFrames > 0)
+        ingestSpan(frames, numFrames);
+}
+
+bool FeatureCollector::writeSnapshotNow(const SnapshotRequest& request)
+{
+    jassert(threading == Threading::inlineOnly);
+    // The input has ended, so its last partial interval is complete.
+    aggregator.closeTimelineInterval();
+    writingSnapshot.store(true);
+    const bool ok = writeSnapshot(request);
+    writingSnapshot.store(false);
+    return ok;
+}
+
+GlobalFeatures FeatureCollector::finishInline()
+{
+    jassert(threading == Threading::inlineOnly);
+    aggregator.closeTimelineInterval();
+    return aggregator.globalFeatures();
 }
 
 void FeatureCollector::requestSnapshot(const SnapshotRequest& request)
@@ -81,7 +391,41 @@ void FeatureCollector::requestSnapshot(const SnapshotRequest& request)
         pendingSnapshot = request;
     }
     snapshotRequested.store(true);
-    notify();
+    wakeService();
+}
+
+void FeatureCollector::startLiveCapture(const SnapshotRequest& request, double flushIntervalSec)
+{
+    {
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        pendingLive = request;
+        pendingLiveIntervalSec = flushIntervalSec;
+    }
+    liveCommand.store(LiveCommand::start);
+    wakeService();
+}
+
+void FeatureCollector::stopLiveCapture()
+{
+    liveCommand.store(LiveCommand::stop);
+    wakeService();
+}
+
+bool FeatureCollector::isLiveCapturing() const
+{
+    return liveCapturing.load();
+}
+
+juce::String FeatureCollector::getLiveCapturePath() const
+{
+    const std::lock_guard<std::mutex> lock(requestMutex);
+    return livePath;
+}
+
+juce::String FeatureCollector::getLiveBusSegmentName() const
+{
+    const std::lock_guard<std::mutex> lock(requestMutex);
+    return liveBusSegmentName;
 }
 
 juce::String FeatureCollector::getLastWritePath() const
@@ -94,18 +438,64 @@ bool FeatureCollector::isWritingSnapshot() const
     return writingSnapshot.load();
 }
 
+int64_t FeatureCollector::getDroppedFrameCount() const
+{
+    return droppedFrames.load(std::memory_order_relaxed);
+}
+
+int64_t FeatureCollector::getDroppedSpectralSampleCount() const
+{
+    return sampleTap.getOverrunSamples();
+}
+
+void FeatureCollector::readOverview(double startSec, double endSec, int numColumns,
+                                    std::vector<TimelinePyramid::Bin>& columns) const
+{
+    columns.resize((size_t) std::max(0, numColumns));
+    const std::lock_guard<std::mutex> lock(pyramidMutex);
+    aggregator.pyramid.render(startSec, endSec, columns.data(), numColumns);
+}
+
+double FeatureCollector::getOverviewEndSec() const
+{
+    const std::lock_guard<std::mutex> lock(pyramidMutex);
+    return aggregator.pyramid.endSec();
+}
+
 void FeatureCollector::Aggregator::reset()
 {
     totalSeconds = 0.0;
     sumSquares = 0.0;
     totalSamples = 0;
     maxPeak = 0.0f;
-    lastTimelineWrite = -1.0;
+    maxTruePeak = 0.0f;
+    openInterval = -1;
+    intervalSumSquares = 0.0;
+    intervalSamples = 0;
+    intervalPeak = 0.0f;
+    loudness.reset();
+    spectral.reset();
+    tempo.reset();
     timeline.clear();
+    pyramid.clear();
 }
 
 void FeatureCollector::Aggregator::ingest(const ProbeFrame& frame)
 {
+    // A timeline point pools every frame that starts inside its interval, so short
+    // peaks are kept and the envelope does not depend on the host block size.
+    // Closed before this frame reaches the loudness meter, so the point's LUFS
+    // describe the interval itself.
+    const auto interval = (int64_t) std::floor(frame.timestampSec / kTimelineSpacingSec);
+    if (interval != openInterval)
+    {
+        closeTimelineInterval();
+        openInterval = interval;
+    }
+    intervalSumSquares += frame.sumSquares;
+    intervalSamples += frame.sampleCount;
+    intervalPeak = std::max(intervalPeak, frame.peakLinear);
+
     const double blockDuration = frame.sampleCount > 0 && sampleRate > 0.0
                                      ? (double) frame.sampleCount / sampleRate
                                      : 0.0;
@@ -113,48 +503,164 @@ void FeatureCollector::Aggregator::ingest(const ProbeFrame& frame)
     sumSquares += frame.sumSquares;
     totalSamples += frame.sampleCount;
     maxPeak = std::max(maxPeak, frame.peakLinear);
+    maxTruePeak = std::max({ maxTruePeak, frame.truePeakLinear, frame.peakLinear });
+    loudness.ingest(frame.kWeightedEnergy, frame.samplesPerChannel);
+
+    if (frame.sampleCount > 0 && sampleRate > 0.0)
+        pyramid.ingest(frame.timestampSec, (double) frame.samplesPerChannel / sampleRate,
+                       frame.sumSquares / frame.sampleCount, frame.peakLinear);
+}
 
-    const bool first = lastTimelineWrite < 0.0;
-    const bool spacedOut = (frame.timestampSec - lastTimelineWrite) >= kTimelineSpacingSec;
-    if (first || spacedOut)
+void FeatureCollector::Aggregator::closeTimelineInterval()
+{
+    if (openInterval >= 0 && intervalSamples > 0)
     {
-        lastTimelineWrite = frame.timestampSec;
-        const auto rmsLinear = std::sqrt(frame.sumSquares / std::max(1, frame.sampleCount));
+        const auto rmsLinear = std::sqrt(intervalSumSquares / (double) intervalSamples);
         TimelinePoint point;
-        point.timeSec = frame.timestampSec;
+        point.timeSec = (double) openInterval * kTimelineSpacingSec;
         point.rmsDb = (float) juce::Decibels::gainToDecibels(rmsLinear + kEpsilon);
-        point.peakDb = (float) juce::Decibels::gainToDecibels(frame.peakLinear + kEpsilon);
-        timeline.push_back(point);
+        point.peakDb = (float) juce::Decibels::gainToDecibels(intervalPeak + kEpsilon);
+        point.momentaryLufs = (float) loudness.momentaryLufs();
+        point.shortTermLufs = (float) loudness.shortTermLufs();
+        if (spectral.isEnabled())
+        {
+            point.spectral = spectral.takePointFeatures();
+            point.tempoBpm = (float) tempo.currentBpm();
+        }
+        timeline.push(point);
     }
+    openInterval = -1;
+    intervalSumSquares = 0.0;
+    intervalSamples = 0;
+    intervalPeak = 0.0f;
+}
+
+bool FeatureCollector::serviceCollector()
+{
+    // Samples first, so the hops behind a timeline point are in before the point is made.
+    const bool drainedSamples = drainSamples();
+    const bool drained = drainFrames() || drainedSamples;
+    const bool live = serviceLiveCapture(juce::Time::getMillisecondCounterHiRes());
+    serviceLiveBus();
+    const bool wrote = writeSnapshotIfRequested();
+    return drained || live || wrote;
+}
+
+// Render thread, non-realtime: the writer pass minus the drains. This runs per
+// rendered block, so live capture keeps time on the render clock (its flush
+// interval is in rendered seconds) and the bus publishes once per timeline
+// point; only the snapshot check runs every span.
+void FeatureCollector::serviceInline()
+{
+    const double renderedSec = aggregator.totalSeconds;
+    serviceLiveCapture(renderedSec * 1000.0);
+    if (renderedSec >= inlineBusDueSec)
+    {
+        inlineBusDueSec = renderedSec + kTimelineSpacingSec;
+        serviceLiveBus();
+    }
+    writeSnapshotIfRequested();
+}
+
+bool FeatureCollector::drainFrames()
+{
+    // Take everything that is ready in one handshake; the second region covers the wrap.
+    const int numReady = fifo.getNumReady();
+    if (numReady <= 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+    ingestSpan(fifoBuffer.data() + start1, size1);
+    ingestSpan(fifoBuffer.data() + start2, size2);
+    fifo.finishedRead(size1 + size2);
+    return true;
+}
+
+bool FeatureCollector::drainSamples()
+{
+    // Spans are read in place; the tap slots are released once analysed.
+    return sampleTap.read([this](const float* const* channels, int numChannels, int numSamples)
+                          { analyseSamples(channels, numChannels, numSamples); }) > 0;
+}
+
+void FeatureCollector::ingestSpan(const ProbeFrame* frames, int numFrames)
+{
+    // Once per span, not per frame; readers only hold it to pool a few bins per column.
+    const std::lock_guard<std::mutex> lock(pyramidMutex);
+    for (int i = 0; i < numFrames; ++i)
+        aggregator.ingest(frames[i]);
 }
 
-void FeatureCollector::run()
+bool FeatureCollector::serviceLiveCapture(double nowMs)
 {
-    while (! threadShouldExit())
+    const auto command = liveCommand.exchange(LiveCommand::none);
+
+    if (command != LiveCommand::none && liveWriter.isOpen())
+        liveWriter.close(aggregator.timeline, aggregator.globalFeatures());
+
+    if (command == LiveCommand::start)
+    {
+        SnapshotRequest requestCopy;
+        double intervalSec = 2.0;
+        {
+            const std::lock_guard<std::mutex> lock(requestMutex);
+            requestCopy = pendingLive;
+            intervalSec = pendingLiveIntervalSec;
+        }
+
+        const auto timestamp = juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
+        const auto file = resolveTrackFolder(requestCopy).getChildFile("live_" + timestamp)
+                                                         .getChildFile(LiveCaptureWriter::kFileName);
+        liveIntervalMs = juce::jmax(0.1, intervalSec) * 1000.0;
+        lastLiveFlushMs = nowMs;
+        if (liveWriter.open(file, requestCopy))
+            liveWriter.flush(aggregator.timeline, aggregator.globalFeatures());
+    }
+
+    if (command != LiveCommand::none)
     {
-        drainFrames();
-        writeSnapshotIfRequested();
-        wait(25);
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        livePath = liveWriter.isOpen() ? liveWriter.getFile().getFullPathName() : juce::String();
+        liveCapturing.store(liveWriter.isOpen());
     }
+
+    if (liveWriter.isOpen() && nowMs - lastLiveFlushMs >= liveIntervalMs)
+    {
+        lastLiveFlushMs = nowMs;
+        liveWriter.flush(aggregator.timeline, aggregator.globalFeatures());
+    }
+    return command != LiveCommand::none;
 }
 
-void FeatureCollector::drainFrames()
+void FeatureCollector::serviceLiveBus()
 {
-    while (fifo.getNumReady() > 0)
+    if (! liveBusEnabled || liveBusFailed)
+        return;
+
+    if (! liveBus.isOpen())
     {
-        int start1, size1, start2, size2;
-        fifo.prepareToRead(1, start1, size1, start2, size2);
-        if (size1 > 0)
-            aggregator.ingest(fifoBuffer[(size_t) start1]);
-        fifo.finishedRead(size1);
-        juce::ignoreUnused(start2, size2);
+        liveBusFailed = ! liveBus.open(spectralConfig.enabled);
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        liveBusSegmentName = liveBus.getSegmentName();
+        if (liveBusFailed)
+            return;
     }
+
+    if (liveBusIdentityChanged.exchange(false))
+    {
+        const std::lock_guard<std::mutex> lock(requestMutex);
+        liveBus.setIdentity(liveBusTrackId, liveBusSessionId);
+    }
+
+    // Every pass, so the heartbeat keeps ticking while idle (at the idle wait rate).
+    liveBus.publish(aggregator.timeline, aggregator.globalFeatures(), aggregator.sampleRate);
 }
 
-void FeatureCollector::writeSnapshotIfRequested()
+bool FeatureCollector::writeSnapshotIfRequested()
 {
     if (! snapshotRequested.load())
-        return;
+        return false;
 
     SnapshotRequest requestCopy;
     {
@@ -166,6 +672,155 @@ void FeatureCollector::writeSnapshotIfRequested()
     writingSnapshot.store(true);
     writeSnapshot(requestCopy);
     writingSnapshot.store(false);
+    return true;
+}
+
+GlobalFeatures FeatureCollector::Aggregator::globalFeatures() const
+{
+    const double integratedRmsLinear = std::sqrt(sumSquares / (double) std::max<int64_t>(1, totalSamples));
+
+    GlobalFeatures global;
+    global.durationSec = totalSeconds;
+    global.integratedRmsDb = juce::Decibels::gainToDecibels(integratedRmsLinear + kEpsilon);
+    global.peakDb = juce::Decibels::gainToDecibels((double) maxPeak + kEpsilon);
+    global.crestDb = global.peakDb - global.integratedRmsDb;
+    global.integratedLufs = loudness.integratedLufs();
+    global.maxMomentaryLufs = loudness.maxMomentaryLufs();
+    global.maxShortTermLufs = loudness.maxShortTermLufs();
+    global.truePeakDbtp = juce::Decibels::gainToDecibels((double) maxTruePeak + kEpsilon);
+    global.spectral = spectral.sessionFeatures();
+    if (spectral.isEnabled())
+    {
+        global.bpm = tempo.globalBpm();
+        global.bpmConfidence = tempo.globalConfidence();
+        global.onsetCount = tempo.onsetCount();
+        global.onsetRateHz = totalSeconds > 0.0 ? (double) global.onsetCount / totalSeconds : 0.0;
+    }
+    return global;
+}
+
+void FeatureCollector::writeSidecarJson(juce::OutputStream& stream, const SnapshotRequest& request) const
+{
+    JsonStreamWriter json(stream);
+    json.beginObject();
+    SidecarSchema::writeMetadata(json, request);
+    json.field("generated_at", juce::Time::getCurrentTime().toISO8601(true));
+    json.field("timeline_mode", aggregator.timeline.isRing() ? "ring" : "linear");
+    json.field("timeline_dropped_points", aggregator.timeline.droppedPoints() + aggregator.timeline.overwrittenPoints());
+    if (aggregator.spectral.isEnabled())
+    {
+        json.field("spectral_hops_analysed", aggregator.spectral.analysedHops());
+        json.field("spectral_hops_skipped", aggregator.spectral.skippedHops());
+        json.field("spectral_dropped_samples", getDroppedSpectralSampleCount());
+    }
+    if (request.includeDiagnostics)
+        writeDiagnostics(json);
+
+    json.beginObject("features");
+    json.beginObject("global");
+    SidecarSchema::writeGlobal(json, aggregator.globalFeatures());
+    json.endObject();
+
+    json.beginArray("timeline");
+    aggregator.timeline.forEach([&json](const TimelinePoint& point)
+    {
+        json.beginObject(true);
+        SidecarSchema::writeTimelinePoint(json, point);
+        json.endObject();
+    });
+    json.endArray();
+
+    // Requested pyramid levels (MA_PROBE_PYRAMID_LEVELS), finest first.
+    if (request.pyramidLevels != 0)
+    {
+        json.beginArray("pyramid");
+        for (int level = 0; level < TimelinePyramid::kNumLevels; ++level)
+            if ((request.pyramidLevels & (1u << level)) != 0)
+                SidecarSchema::writePyramidLevel(json, aggregator.pyramid, level);
+        json.endArray();
+    }
+    json.endObject(); // features
+
+    json.endObject();
+    json.finish();
+}
+
+// Optional "diagnostics" object (MA_PROBE_DIAGNOSTICS=1): the telemetry at write time.
+void FeatureCollector::writeDiagnostics(JsonStreamWriter& json) const
+{
+    const auto t = telemetry.report();
+    json.beginObject("diagnostics");
+    json.field("blocks", t.blocks);
+    json.field("deadline_overruns", t.deadlineOverruns);
+    json.field("block_load_mean_pct", t.meanLoadPct);
+    json.field("block_load_p50_pct", t.p50LoadPct);
+    json.field("block_load_p99_pct", t.p99LoadPct);
+    json.field("block_load_max_pct", t.maxLoadPct);
+    // Non-empty buckets only; `le_pct` is the bucket's upper edge.
+    json.beginArray("block_load_histogram");
+    for (int i = 0; i < ProbeTelemetry::kNumBuckets; ++i)
+    {
+        if (t.histogram[(size_t) i] == 0)
+            continue;
+        json.beginObject(true);
+        json.field("le_pct", ProbeTelemetry::bucketUpperPct(i));
+        json.field("count", t.histogram[(size_t) i]);
+        json.endObject();
+    }
+    json.endArray();
+    json.field("fifo_high_water", (int64_t) t.fifoHighWater);
+    json.field("fifo_capacity", (int64_t) t.fifoCapacity);
+    json.field("dropped_frames", getDroppedFrameCount());
+    json.field("raw_tap_overrun_samples", sampleTap.getOverrunSamples());
+    json.field("raw_tap_overrun_events", sampleTap.getOverrunEvents());
+    json.field("snapshot_writes", t.snapshotWrites);
+    json.field("last_snapshot_write_ms", t.lastSnapshotWriteMs);
+    json.field("max_snapshot_write_ms", t.maxSnapshotWriteMs);
+    json.endObject();
+}
+
+bool FeatureCollector::writeColumnarTimeline(const juce::File& snapshotFolder,
+                                             const SnapshotRequest& request) const
+{
+    juce::TemporaryFile temp(snapshotFolder.getChildFile(ColumnarTimeline::kFileName));
+    {
+        juce::FileOutputStream out(temp.getFile(), kSidecarWriteBufferBytes);
+        if (! out.openedOk())
+            return false;
+
+        ColumnarTimeline::write(out, aggregator.timeline, SidecarSchema::kVersion, request.sampleRate);
+        if (out.getStatus().failed())
+            return false;
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+void FeatureCollector::appendIndexRecord(const juce::File& sidecar, const SnapshotRequest& request) const
+{
+    const auto indexFolder = resolveTrackFolder(request).getParentDirectory();
+    const auto global = aggregator.globalFeatures();
+
+    auto record = ma::index::makeRecord();
+    record.writtenAtMs = juce::Time::currentTimeMillis();
+    record.durationSec = global.durationSec;
+    record.sampleRate = request.sampleRate;
+    record.integratedLufs = global.integratedLufs;
+    record.integratedRmsDb = global.integratedRmsDb;
+    record.peakDb = global.peakDb;
+    record.truePeakDbtp = global.truePeakDbtp;
+    record.crestDb = global.crestDb;
+    record.maxMomentaryLufs = global.maxMomentaryLufs;
+    record.maxShortTermLufs = global.maxShortTermLufs;
+    record.bpm = global.bpm;
+    ma::index::setField(record.source, "juce_probe");
+    if (! ma::index::setField(record.trackId, sanitiseId(request.trackId).toStdString())
+        || ! ma::index::setField(record.sessionId, request.sessionId.toStdString()))
+        record.flags |= ma::index::kFlagIdTruncated;
+    const auto relative = sidecar.getRelativePathFrom(indexFolder).replaceCharacter('\\', '/');
+    if (! ma::index::setField(record.relativePath, relative.toStdString()))
+        record.flags |= ma::index::kFlagPathTruncated;
+
+    ma::index::appendRecord(indexFolder.getChildFile(ma::index::kIndexFileName).getFullPathName().toStdString(), record);
 }
 
 bool FeatureCollector::writeSnapshot(const SnapshotRequest& request)
@@ -173,10 +828,17 @@ bool FeatureCollector::writeSnapshot(const SnapshotRequest& request)
     if (aggregator.totalSamples <= 0)
         return false;
 
-    const auto dataRoot = resolveDataRoot(request);
-    const auto featuresRoot = dataRoot.getChildFile("features_output");
-    const auto probeRoot = featuresRoot.getChildFile("juce_probe");
-    const auto trackFolder = probeRoot.getChildFile(sanitiseId(request.trackId));
+    // Timed end to end (folder, JSON, swap, columnar); the sidecar reports the
+    // previous write, since this one is still in progress while it is written.
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+    struct RecordOnExit
+    {
+        ProbeTelemetry& telemetry;
+        double startMs;
+        ~RecordOnExit() { telemetry.recordSnapshotWrite(juce::Time::getMillisecondCounterHiRes() - startMs); }
+    } recordOnExit{ telemetry, startMs };
+
+    const auto trackFolder = resolveTrackFolder(request);
 
     const auto timestamp = juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
     const auto snapshotFolder = trackFolder.getChildFile(timestamp);
@@ -185,52 +847,28 @@ bool FeatureCollector::writeSnapshot(const SnapshotRequest& request)
 
     const auto outputFile = snapshotFolder.getChildFile("juce_probe_features.json");
 
-    const double integratedRmsLinear = std::sqrt(aggregator.sumSquares / (double) std::max<int64_t>(1, aggregator.totalSamples));
-    const double integratedRmsDb = juce::Decibels::gainToDecibels(integratedRmsLinear + kEpsilon);
-    const double peakDb = juce::Decibels::gainToDecibels((double) aggregator.maxPeak + kEpsilon);
-    const double crestDb = peakDb - integratedRmsDb;
-
-    juce::DynamicObject::Ptr root = new juce::DynamicObject();
-    root->setProperty("version", "juce_probe_features_v1");
-    root->setProperty("track_id", request.trackId);
-    root->setProperty("session_id", request.sessionId);
-    root->setProperty("host", request.hostName);
-    root->setProperty("sample_rate", request.sampleRate);
-    root->setProperty("generated_at", juce::Time::getCurrentTime().toISO8601(true));
-    root->setProperty("build", request.buildId);
-
-    juce::DynamicObject::Ptr features = new juce::DynamicObject();
-    juce::DynamicObject::Ptr global = new juce::DynamicObject();
-    global->setProperty("duration_sec", aggregator.totalSeconds);
-    global->setProperty("integrated_rms_db", integratedRmsDb);
-    global->setProperty("peak_db", peakDb);
-    global->setProperty("crest_factor_db", crestDb);
-    features->setProperty("global", juce::var(global.get()));
-
-    juce::Array<juce::var> timelineArray;
-    timelineArray.ensureStorageFree((int) aggregator.timeline.size());
-    for (const auto& point : aggregator.timeline)
-    {
-        juce::DynamicObject::Ptr obj = new juce::DynamicObject();
-        obj->setProperty("time_sec", point.timeSec);
-        obj->setProperty("rms_db", point.rmsDb);
-        obj->setProperty("peak_db", point.peakDb);
-        timelineArray.add(juce::var(obj.get()));
-    }
-    features->setProperty("timeline", juce::var(timelineArray));
-    root->setProperty("features", juce::var(features.get()));
-
-    juce::MemoryOutputStream jsonStream;
-    jsonStream << juce::JSON::toString(juce::var(root.get()), true);
-
-    juce::FileOutputStream out(outputFile);
-    if (! out.openedOk())
+    // Stream straight into a temp file next to the target, then swap it in so
+    // watchers never see a half-written sidecar.
+    juce::TemporaryFile temp(outputFile);
+    {
+        juce::FileOutputStream out(temp.getFile(), kSidecarWriteBufferBytes);
+        if (! out.openedOk())
+            return false;
+
+        writeSidecarJson(out, request);
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
         return false;
 
-    out.setPosition(0);
-    out.truncate();
-    out.writeText(jsonStream.toString(), false, false, "\n");
-    out.flush();
+    // The columnar file is optional; a failure there does not invalidate the JSON.
+    if (request.writeColumnarTimeline)
+        writeColumnarTimeline(snapshotFolder, request);
+
+    // Likewise the index: the snapshot is still found by walking the folders.
+    appendIndexRecord(outputFile, request);
 
     lastWritePath = outputFile.getFullPathName();
     return true;
@@ -3,78 +3,219 @@
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
 
-// One analysis frame pushed from the audio thread.
-struct ProbeFrame
-{
-    double timestampSec{};
-    double sumSquares{};
-    int sampleCount{};
-    float peakLinear{};
-};
+#include <optional>
 
-struct TimelinePoint
-{
-    double timeSec{};
-    float rmsDb{};
-    float peakDb{};
-};
+#include "CollectorService.h"
+#include "FeatureTypes.h"
+#include "LiveCaptureWriter.h"
+#include "LiveFeatureBus.h"
+#include "LoudnessAggregator.h"
+#include "ProbeTelemetry.h"
+#include "RawSampleTap.h"
+#include "SpectralAnalyzer.h"
+#include "TempoTracker.h"
+#include "TimelinePyramid.h"
+#include "TimelineStore.h"
 
-struct SnapshotRequest
-{
-    juce::String trackId{"untitled"};
-    juce::String sessionId{"session"};
-    juce::String hostName{"UnknownHost"};
-    juce::String dataRootOverride{}; // optional MA_DATA_ROOT override from UI/env
-    juce::String buildId{"dev"};
-    double sampleRate{};
-};
+class JsonStreamWriter;
 
 // Drains RT frames, aggregates loudness/peaks, and writes JSON snapshots on demand.
-class FeatureCollector : private juce::Thread
+// All instances in a process share one CollectorService writer thread, unless
+// built as Threading::inlineOnly (offline tools), which never touches the thread.
+class FeatureCollector : private CollectorService::Client
 {
 public:
-    FeatureCollector();
+    enum class Threading { sharedService, inlineOnly };
+
+    explicit FeatureCollector(Threading threading = Threading::sharedService);
     ~FeatureCollector() override;
 
-    void prepare(double sampleRate, int maxBlockSize);
+    // Message thread. Allocates the FIFO, timeline and (when a stage uses it) the
+    // raw sample tap, and joins the shared writer thread, starting it if this is
+    // the first active instance. `numChannels` sizes the raw sample tap.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels = 2);
     void reset();
 
-    // Audio thread safe: lock-free push, drops frame if FIFO is saturated.
+    // Message thread (releaseResources): leaves the writer thread, closes live
+    // capture and the live bus, and frees the FIFO, timeline and sample tap.
+    // The last released instance stops the thread. prepare() starts over.
+    void release();
+
+    // Message thread, audio stopped (AudioProcessor::setNonRealtime), sharedService
+    // only. Offline: leaves the writer thread and starts a fresh session; from
+    // then on push* aggregate on the render thread itself, losslessly and with
+    // the spectral CPU budget lifted, and snapshot requests are serviced there
+    // after each span (live capture and the bus on the render clock). Back to realtime: rejoins the writer thread.
+    // The mode survives release()/prepare().
+    void setNonRealtime(bool nonRealtime);
+
+    // Message thread, while non-realtime: closes the render's last timeline
+    // interval and writes its sidecar on the calling thread. False if nothing
+    // was rendered since the previous offline snapshot, or the write failed
+    // (failures, including exceptions, are logged rather than thrown).
+    bool writeOfflineSnapshot(const SnapshotRequest& request);
+
+    // Any thread, while non-realtime, just before setNonRealtime(false): closes
+    // the render's last timeline interval and hands its sidecar to the writer
+    // thread, which writes it on the first pass after rejoining. No file I/O
+    // here, so it suits noexcept callbacks. False if nothing was rendered.
+    bool queueOfflineSnapshot(const SnapshotRequest& request);
+
+    // Message thread, before prepare(): bounds timeline memory per instance.
+    void setTimelineConfig(const TimelineStore::Config& config);
+
+    // Message thread, before prepare(): enables the STFT stage and its CPU budget.
+    void setSpectralConfig(const SpectralAnalyzer::Config& config);
+
+    // Message thread, before prepare(): publish aggregates and the timeline tail on
+    // the shared-memory live bus (sharedService only). Opened by the writer thread
+    // on its next pass; if shared memory is unavailable it is not retried.
+    void setLiveBusEnabled(bool enabled);
+
+    // Any non-RT thread: track/session ids shown in the live bus registry.
+    void setLiveBusIdentity(const juce::String& trackId, const juce::String& sessionId);
+
+    // Audio thread safe: copies the block into the raw sample tap (one memcpy per
+    // channel). No-op unless a sample stage (spectral) is enabled; samples that
+    // do not fit are counted as tap overruns.
+    void pushSamples(const float* const* channels, int numChannels, int numSamples);
+
+    // Audio thread safe: lock-free push, drops frame if FIFO is saturated
+    // (non-realtime: aggregated in place, never dropped).
     void pushFrame(const ProbeFrame& frame);
 
+    // Audio thread safe: pushes a contiguous span in one FIFO handshake, using both
+    // ring regions. Returns the number of frames dropped because the FIFO was full.
+    int pushFrames(const ProbeFrame* frames, int numFrames);
+
+    // inlineOnly: aggregate frames / samples on the calling thread, bypassing the FIFOs.
+    // Feed a block's samples before its frame so timeline points line up.
+    void ingestFrames(const ProbeFrame* frames, int numFrames);
+    void ingestSamples(const float* const* channels, int numChannels, int numSamples);
+
+    // inlineOnly: write the sidecar synchronously on the calling thread.
+    bool writeSnapshotNow(const SnapshotRequest& request);
+
+    // inlineOnly, after the last block: closes the open timeline interval (as
+    // writeSnapshotNow does) and returns the session features a sidecar would
+    // hold; getTimeline() then holds its timeline. For in-process consumers.
+    GlobalFeatures finishInline();
+    const TimelineStore& getTimeline() const { return aggregator.timeline; }
+
     // UI thread: request a JSON snapshot at the next drain.
     void requestSnapshot(const SnapshotRequest& request);
 
+    // UI thread: start/stop live capture. The writer thread appends new timeline
+    // points to one per-session file every `flushIntervalSec`.
+    void startLiveCapture(const SnapshotRequest& request, double flushIntervalSec);
+    void stopLiveCapture();
+
     // Non-RT query helpers.
     juce::String getLastWritePath() const;
+    bool isLiveCapturing() const;
+    juce::String getLiveCapturePath() const;
+    juce::String getLiveBusSegmentName() const; // empty until the bus is open
     bool isWritingSnapshot() const;
+    int64_t getDroppedFrameCount() const;
+    int64_t getDroppedSpectralSampleCount() const; // raw tap overrun samples
+
+    // Any non-RT thread: `numColumns` min/max/mean bins over [startSec, endSec)
+    // from the timeline pyramid, at the coarsest level that still resolves one
+    // column. Cheap enough for an editor timer, whatever the session length.
+    void readOverview(double startSec, double endSec, int numColumns, std::vector<TimelinePyramid::Bin>& columns) const;
+    double getOverviewEndSec() const; // end of the newest completed 10 ms bin
+
+    // Hot-path counters; the processor records block load, the collector FIFO
+    // fill and snapshot write time. Reset by prepare().
+    ProbeTelemetry& getTelemetry() { return telemetry; }
+    const ProbeTelemetry& getTelemetry() const { return telemetry; }
 
 private:
-    void run() override;
-    void drainFrames();
-    void writeSnapshotIfRequested();
+    bool serviceCollector() override;
+    void leaveService();
+    void joinService();
+    void wakeService();
+    void serviceInline();
+    bool drainFrames();
+    bool drainSamples();
+    void analyseSamples(const float* const* channels, int numChannels, int numSamples);
+    void ingestSpan(const ProbeFrame* frames, int numFrames);
+    bool writeSnapshotIfRequested();
+    bool serviceLiveCapture(double nowMs); // nowMs: wall clock, or the render clock offline
+    void serviceLiveBus();
     bool writeSnapshot(const SnapshotRequest& request);
+    void writeSidecarJson(juce::OutputStream& stream, const SnapshotRequest& request) const;
+    void writeDiagnostics(JsonStreamWriter& json) const;
+    bool writeColumnarTimeline(const juce::File& snapshotFolder, const SnapshotRequest& request) const;
+    void appendIndexRecord(const juce::File& sidecar, const SnapshotRequest& request) const;
 
     struct Aggregator
     {
         void reset();
         void ingest(const ProbeFrame& frame);
+        void closeTimelineInterval(); // pushes the pooled point of the open interval, if any
+        GlobalFeatures globalFeatures() const;
         double sampleRate{48000.0};
         double totalSeconds{0.0};
         double sumSquares{0.0};
         int64_t totalSamples{0};
         float maxPeak{0.0f};
-        double lastTimelineWrite{-1.0};
-        std::vector<TimelinePoint> timeline;
+        float maxTruePeak{0.0f};
+        int64_t openInterval{-1};       // timeline interval the pooled frames below belong to
+        double intervalSumSquares{0.0};
+        int64_t intervalSamples{0};
+        float intervalPeak{0.0f};
+        LoudnessAggregator loudness;
+        SpectralAnalyzer spectral;
+        TempoTracker tempo;             // fed per hop by `spectral`
+        TimelineStore timeline;
+        TimelinePyramid pyramid;        // guarded by pyramidMutex against UI reads
     };
 
+    // Acquired by the first joinService() and kept until destruction, so
+    // instances that are only scanned never touch the shared writer.
+    std::optional<juce::SharedResourcePointer<CollectorService>> service;
+    const Threading threading;
     Aggregator aggregator;
+    ProbeTelemetry telemetry;
+    TimelineStore::Config timelineConfig;
+    SpectralAnalyzer::Config spectralConfig;
     juce::AbstractFifo fifo;
     std::vector<ProbeFrame> fifoBuffer;
+    RawSampleTap sampleTap;                // sharedService only; storage only when spectral is on
+    std::vector<float> mixBuffer;          // mono mixdown scratch on the aggregating thread
+    // Written only by the audio thread; kept off the reader's cache line.
+    alignas(64) std::atomic<int64_t> droppedFrames{0};
+    std::atomic<bool> serviceRegistered{false};
+    std::atomic<bool> nonRealtime{false};
+    std::mutex offlineMutex;              // render thread vs mode switch and offline snapshot
+    int64_t offlineFrames{0};             // guarded by offlineMutex: rendered since the last offline snapshot
     std::atomic<bool> snapshotRequested{false};
     std::atomic<bool> writingSnapshot{false};
     SnapshotRequest pendingSnapshot;
     mutable std::mutex requestMutex;
+    mutable std::mutex pyramidMutex;      // writer ingest vs readOverview()
     juce::String lastWritePath;
-    int fifoCapacity{8192};
+
+    enum class LiveCommand { none, start, stop };
+    std::atomic<LiveCommand> liveCommand{LiveCommand::none};
+    std::atomic<bool> liveCapturing{false};
+    SnapshotRequest pendingLive;          // guarded by requestMutex
+    double pendingLiveIntervalSec{2.0};   // guarded by requestMutex
+    juce::String livePath;                // guarded by requestMutex
+    LiveCaptureWriter liveWriter;         // writer thread only
+    double liveIntervalMs{2000.0};
+    double lastLiveFlushMs{0.0};
+    double inlineBusDueSec{0.0};          // render clock: next offline bus publish
+
+    bool liveBusEnabled{false};
+    bool liveBusFailed{false};            // writer thread only
+    std::atomic<bool> liveBusIdentityChanged{true};
+    juce::String liveBusTrackId{"untitled"};   // guarded by requestMutex
+    juce::String liveBusSessionId{"session"};  // guarded by requestMutex
+    juce::String liveBusSegmentName;           // guarded by requestMutex
+    LiveFeatureBus liveBus;               // writer thread only
+    static constexpr int fifoCapacity = 8192;
+    static constexpr int fifoHighWater = fifoCapacity / 2; // wake the service before the FIFO can overflow
+    static constexpr int kMixChunk = 4096;
 };
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+// One analysis frame pushed from the audio thread.
+struct ProbeFrame
+{
+    double timestampSec{};
+    double sumSquares{};
+    int sampleCount{};            // channel-samples (numChannels * samplesPerChannel)
+    float peakLinear{};
+    double kWeightedEnergy{};     // BS.1770 channel-weighted sum of K-weighted squares
+    int samplesPerChannel{};
+    float truePeakLinear{};       // 4x oversampled
+};
+
+constexpr int kNumOctaveBands = 10; // centres 31.5 Hz .. 16 kHz
+
+// Spectral stage output (SpectralAnalyzer): means over the analysis hops behind
+// one timeline point, or over the session. NaN when the stage is off or saw no hops.
+struct SpectralFeatures
+{
+    SpectralFeatures() { octaveBandDb.fill(std::numeric_limits<float>::quiet_NaN()); }
+    bool isValid() const { return std::isfinite(centroidHz); }
+
+    float centroidHz{std::numeric_limits<float>::quiet_NaN()};
+    float rolloffHz{std::numeric_limits<float>::quiet_NaN()};  // 85% of magnitude
+    float flux{std::numeric_limits<float>::quiet_NaN()};       // rectified log-magnitude difference
+    std::array<float, kNumOctaveBands> octaveBandDb;           // band power re full-scale mean square
+};
+
+struct TimelinePoint
+{
+    double timeSec{};
+    float rmsDb{};
+    float peakDb{};
+    float momentaryLufs{};        // -inf until 400 ms of audio has been seen
+    float shortTermLufs{};        // -inf until 3 s of audio has been seen
+    SpectralFeatures spectral;
+    float tempoBpm{std::numeric_limits<float>::quiet_NaN()}; // ~8 s local estimate (spectral stage)
+};
+
+// Session-level features shared by the snapshot and live writers.
+struct GlobalFeatures
+{
+    double durationSec{};
+    double integratedRmsDb{};
+    double peakDb{};
+    double crestDb{};
+    double integratedLufs{};      // gated (BS.1770-4 / EBU R128)
+    double maxMomentaryLufs{};
+    double maxShortTermLufs{};
+    double truePeakDbtp{};
+    SpectralFeatures spectral;
+    // Tempo/onsets from the spectral flux (TempoTracker); NaN / 0 when the stage is off.
+    double bpm{std::numeric_limits<double>::quiet_NaN()};
+    double bpmConfidence{std::numeric_limits<double>::quiet_NaN()};
+    int64_t onsetCount{};
+    double onsetRateHz{};
+};
+
+struct SnapshotRequest
+{
+    juce::String trackId{"untitled"};
+    juce::String sessionId{"session"};
+    juce::String hostName{"UnknownHost"};
+    juce::String dataRootOverride{}; // optional MA_DATA_ROOT override from UI/env
+    juce::String buildId{"dev"};
+    double sampleRate{};
+    bool writeColumnarTimeline{false}; // also emit juce_probe_timeline.bin (MA_PROBE_COLUMNAR=1)
+    bool includeDiagnostics{false};    // add the "diagnostics" telemetry object (MA_PROBE_DIAGNOSTICS=1)
+    uint32_t pyramidLevels{0};         // TimelinePyramid level bits written under "pyramid" (MA_PROBE_PYRAMID_LEVELS)
+};
@@ -0,0 +1,53 @@
+#include "FrameAnalyzer.h"
+
+#include <ma/dsp/BlockStats.h>
+
+void FrameAnalyzer::prepare(double sampleRate, const juce::AudioChannelSet& layout)
+{
+    kWeighting.prepare(sampleRate, layout.size());
+    truePeak.prepare(layout.size());
+
+    // BS.1770 weights: LFE is excluded, surrounds count +1.5 dB; everything else is 1.0.
+    for (int ch = 0; ch < layout.size(); ++ch)
+    {
+        switch (layout.getTypeOfChannel(ch))
+        {
+            case juce::AudioChannelSet::LFE:
+            case juce::AudioChannelSet::LFE2:
+                kWeighting.setChannelWeight(ch, 0.0);
+                break;
+            case juce::AudioChannelSet::leftSurround:
+            case juce::AudioChannelSet::rightSurround:
+            case juce::AudioChannelSet::leftSurroundRear:
+            case juce::AudioChannelSet::rightSurroundRear:
+            case juce::AudioChannelSet::leftSurroundSide:
+            case juce::AudioChannelSet::rightSurroundSide:
+                kWeighting.setChannelWeight(ch, 1.41);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void FrameAnalyzer::reset()
+{
+    kWeighting.reset();
+    truePeak.reset();
+}
+
+ProbeFrame FrameAnalyzer::analyse(const float* const* channels, int numChannels, int numSamples,
+                                  double timestampSec)
+{
+    const auto stats = ma::dsp::computeBlockStats(channels, numChannels, numSamples);
+
+    ProbeFrame frame;
+    frame.timestampSec = timestampSec;
+    frame.sampleCount = (int) stats.samples;
+    frame.sumSquares = stats.sumSquares;
+    frame.peakLinear = stats.peak;
+    frame.samplesPerChannel = numSamples;
+    frame.kWeightedEnergy = kWeighting.process(channels, numChannels, numSamples);
+    frame.truePeakLinear = truePeak.process(channels, numChannels, numSamples);
+    return frame;
+}
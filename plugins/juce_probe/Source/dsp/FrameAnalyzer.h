@@ -0,0 +1,25 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <ma/dsp/KWeighting.h>
+#include <ma/dsp/TruePeak.h>
+
+#include "FeatureTypes.h"
+
+// Per-block analysis shared by the plugin's processBlock and the offline batch
+// tool: RMS/peak (ma::dsp::computeBlockStats), K-weighted energy and true peak.
+// Real-time safe after prepare(); keeps filter state, so one instance per stream.
+class FrameAnalyzer
+{
+public:
+    // Resets filter state and applies BS.1770 channel weights for `layout`.
+    void prepare(double sampleRate, const juce::AudioChannelSet& layout);
+    void reset();
+
+    ProbeFrame analyse(const float* const* channels, int numChannels, int numSamples, double timestampSec);
+
+private:
+    ma::dsp::KWeightingFilterBank kWeighting;
+    ma::dsp::TruePeakDetector truePeak;
+};
@@ -0,0 +1,169 @@
+#include "JsonStreamWriter.h"
+
+#include <ma/text/NumberFormat.h>
+
+#include <cmath>
+#include <cstring>
+
+JsonStreamWriter::JsonStreamWriter(juce::OutputStream& target)
+    : out(target)
+{
+    scopes.reserve(8);
+}
+
+void JsonStreamWriter::beginObject(bool inlineObject)
+{
+    open('{', nullptr, false, inlineObject);
+}
+
+void JsonStreamWriter::beginObject(const char* key, bool inlineObject)
+{
+    open('{', key, false, inlineObject);
+}
+
+void JsonStreamWriter::endObject()
+{
+    close('}');
+}
+
+void JsonStreamWriter::beginArray(const char* key)
+{
+    open('[', key, true, false);
+}
+
+void JsonStreamWriter::endArray()
+{
+    close(']');
+}
+
+void JsonStreamWriter::field(const char* key, const juce::String& value)
+{
+    beginValue(key);
+    writeString(value);
+}
+
+void JsonStreamWriter::field(const char* key, double value)
+{
+    beginValue(key);
+    writeNumber(value, 15);
+}
+
+void JsonStreamWriter::field(const char* key, float value)
+{
+    beginValue(key);
+    writeNumber((double) value, 7);
+}
+
+void JsonStreamWriter::field(const char* key, int64_t value)
+{
+    beginValue(key);
+    char buffer[ma::text::kNumberBufferBytes];
+    out.write(buffer, ma::text::formatInteger(buffer, sizeof(buffer), value));
+}
+
+void JsonStreamWriter::field(const char* key, bool value)
+{
+    beginValue(key);
+    writeRaw(value ? "true" : "false");
+}
+
+void JsonStreamWriter::value(double value)
+{
+    field(nullptr, value);
+}
+
+void JsonStreamWriter::value(float value)
+{
+    field(nullptr, value);
+}
+
+void JsonStreamWriter::finish(bool flushStream)
+{
+    jassert(scopes.empty());
+    writeRaw("\n");
+    if (flushStream)
+        out.flush();
+}
+
+void JsonStreamWriter::beginValue(const char* key)
+{
+    if (scopes.empty())
+        return;
+
+    auto& scope = scopes.back();
+    if (! scope.empty)
+        writeRaw(scope.isInline ? ", " : ",");
+    if (scope.isInline)
+    {
+        if (scope.empty)
+            writeRaw(" ");
+    }
+    else
+    {
+        newlineAndIndent();
+    }
+    scope.empty = false;
+
+    if (key != nullptr)
+    {
+        // Keys are ASCII literals owned by the caller; no escaping or String copy.
+        out.writeByte('"');
+        writeRaw(key);
+        writeRaw("\": ");
+    }
+}
+
+void JsonStreamWriter::open(char bracket, const char* key, bool isArray, bool inlineScope)
+{
+    beginValue(key);
+    out.writeByte(bracket);
+    const bool parentInline = ! scopes.empty() && scopes.back().isInline;
+    scopes.push_back({ isArray, inlineScope || parentInline, true });
+}
+
+void JsonStreamWriter::close(char bracket)
+{
+    jassert(! scopes.empty());
+    const auto scope = scopes.back();
+    scopes.pop_back();
+
+    if (! scope.empty)
+    {
+        if (scope.isInline)
+            writeRaw(" ");
+        else
+            newlineAndIndent();
+    }
+    out.writeByte(bracket);
+}
+
+void JsonStreamWriter::newlineAndIndent()
+{
+    out.writeByte('\n');
+    out.writeRepeatedByte(' ', scopes.size() * 2);
+}
+
+void JsonStreamWriter::writeRaw(const char* text)
+{
+    out.write(text, std::strlen(text));
+}
+
+void JsonStreamWriter::writeString(const juce::String& value)
+{
+    out.writeByte('"');
+    out << juce::JSON::escapeString(value);
+    out.writeByte('"');
+}
+
+void JsonStreamWriter::writeNumber(double value, int significantDigits)
+{
+    if (! std::isfinite(value))
+    {
+        writeRaw("null"); // JSON has no inf/nan
+        return;
+    }
+
+    // Not snprintf: it follows the host's LC_NUMERIC and could write "-14,2".
+    char buffer[ma::text::kNumberBufferBytes];
+    out.write(buffer, ma::text::formatGeneral(buffer, sizeof(buffer), value, significantDigits));
+}
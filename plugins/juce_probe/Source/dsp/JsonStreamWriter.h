@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <vector>
+
+// Minimal streaming JSON emitter: writes straight to an OutputStream with no
+// intermediate var tree, so memory stays flat regardless of document size.
+// Objects opened with `inlineObject = true` are written on one line (timeline rows).
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(juce::OutputStream& target);
+
+    void beginObject(bool inlineObject = false);
+    void beginObject(const char* key, bool inlineObject = false);
+    void endObject();
+
+    void beginArray(const char* key);
+    void endArray();
+
+    void field(const char* key, const juce::String& value);
+    void field(const char* key, const char* value) { field(key, juce::String(value)); }
+    void field(const char* key, double value);
+    void field(const char* key, float value);
+    void field(const char* key, int64_t value);
+    void field(const char* key, bool value);
+
+    // Bare array elements.
+    void value(double value);
+    void value(float value);
+
+    // Finishes the document (or one NDJSON line) with a trailing newline.
+    void finish(bool flushStream = true);
+
+private:
+    struct Scope
+    {
+        bool isArray{false};
+        bool isInline{false};
+        bool empty{true};
+    };
+
+    void beginValue(const char* key);
+    void open(char bracket, const char* key, bool isArray, bool inlineScope);
+    void close(char bracket);
+    void newlineAndIndent();
+    void writeRaw(const char* text);
+    void writeString(const juce::String& value);
+    void writeNumber(double value, int significantDigits);
+
+    juce::OutputStream& out;
+    std::vector<Scope> scopes;
+};
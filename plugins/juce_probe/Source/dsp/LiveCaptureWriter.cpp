@@ -0,0 +1,92 @@
+#include "LiveCaptureWriter.h"
+#include "JsonStreamWriter.h"
+#include "SidecarSchema.h"
+
+namespace
+{
+constexpr size_t kLiveWriteBufferBytes = 1 << 15;
+}
+
+bool LiveCaptureWriter::open(const juce::File& target, const SnapshotRequest& request)
+{
+    stream.reset();
+    if (! target.getParentDirectory().createDirectory())
+        return false;
+
+    auto out = std::make_unique<juce::FileOutputStream>(target, kLiveWriteBufferBytes);
+    if (! out->openedOk())
+        return false;
+
+    out->setPosition(0);
+    out->truncate();
+
+    JsonStreamWriter json(*out);
+    json.beginObject(true);
+    json.field("type", "header");
+    SidecarSchema::writeMetadata(json, request);
+    json.field("started_at", juce::Time::getCurrentTime().toISO8601(true));
+    json.endObject();
+    json.finish();
+
+    file = target;
+    trailerOffset = out->getPosition();
+    nextIndex = 0;
+    haveGeneration = false;
+    stream = std::move(out);
+    return true;
+}
+
+void LiveCaptureWriter::flush(const TimelineStore& timeline, const GlobalFeatures& global, bool complete)
+{
+    if (stream == nullptr)
+        return;
+
+    // New rows and the new trailer overwrite the previous trailer; the file is
+    // cut at the new end only afterwards, so it never ends without a summary.
+    stream->setPosition(trailerOffset);
+
+    JsonStreamWriter json(*stream);
+    const auto first = timeline.firstRetainedIndex();
+    const auto end = first + (int64_t) timeline.size();
+    if (haveGeneration && timeline.generation() != timelineGeneration)
+    {
+        // The collector was reset (transport restart / prepare); times start over.
+        // Compared by generation: the new session may already be longer than the old.
+        json.beginObject(true);
+        json.field("type", "reset");
+        json.endObject();
+        json.finish(false);
+        nextIndex = 0;
+    }
+
+    for (auto index = std::max(nextIndex, first); index < end; ++index)
+    {
+        json.beginObject(true);
+        json.field("type", "point");
+        SidecarSchema::writeTimelinePoint(json, timeline[(size_t) (index - first)]);
+        json.endObject();
+        json.finish(false);
+    }
+    nextIndex = end;
+    timelineGeneration = timeline.generation();
+    haveGeneration = true;
+    trailerOffset = stream->getPosition();
+
+    json.beginObject(true);
+    json.field("type", "summary");
+    json.field("updated_at", juce::Time::getCurrentTime().toISO8601(true));
+    json.field("complete", complete);
+    json.field("points", end);
+    json.beginObject("global");
+    SidecarSchema::writeGlobal(json, global);
+    json.endObject();
+    json.endObject();
+    json.finish();
+    stream->truncate(); // drops what is left of a longer previous trailer
+}
+
+void LiveCaptureWriter::close(const TimelineStore& timeline, const GlobalFeatures& global)
+{
+    flush(timeline, global, true);
+    stream.reset();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "FeatureTypes.h"
+#include "TimelineStore.h"
+
+// Incremental per-session sidecar (`juce_probe_live.ndjson`). One JSON object per
+// line: a "header", then "point" rows appended as they arrive, and a single
+// "summary" trailer. Each flush writes the new rows and summary over the old
+// trailer and only then truncates, so I/O is proportional to the new points and
+// the file never ends without a summary (a reader racing a flush can still see
+// a half-written line and should retry). Writer-thread only.
+class LiveCaptureWriter
+{
+public:
+    static constexpr const char* kFileName = "juce_probe_live.ndjson";
+
+    bool open(const juce::File& file, const SnapshotRequest& request);
+    // Appends points pushed since the previous flush and rewrites the trailer.
+    void flush(const TimelineStore& timeline, const GlobalFeatures& global, bool complete = false);
+    void close(const TimelineStore& timeline, const GlobalFeatures& global);
+
+    bool isOpen() const { return stream != nullptr; }
+    juce::File getFile() const { return file; }
+
+private:
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::File file;
+    juce::int64 trailerOffset{0};
+    int64_t nextIndex{0};
+    uint64_t timelineGeneration{0};
+    bool haveGeneration{false}; // false until the first flush after open()
+};
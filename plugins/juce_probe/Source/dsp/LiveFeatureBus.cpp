@@ -0,0 +1,349 @@
+#include "LiveFeatureBus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if JUCE_MAC || JUCE_LINUX || JUCE_BSD
+ #define MA_LIVE_BUS_POSIX 1
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#else
+ #define MA_LIVE_BUS_POSIX 0
+#endif
+
+using namespace ma::bus;
+
+namespace
+{
+uint64_t unixTimeNs()
+{
+    using namespace std::chrono;
+    return (uint64_t) duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// NUL-padded copy that never splits a UTF-8 sequence.
+void copyId(char (&dest)[kIdBytes], const juce::String& source)
+{
+    const char* utf8 = source.toRawUTF8();
+    const auto fullLength = std::strlen(utf8);
+    auto length = std::min(fullLength, (size_t) kIdBytes - 1);
+    while (length > 0 && length < fullLength && (((unsigned char) utf8[length]) & 0xC0) == 0x80)
+        --length;
+    std::memset(dest, 0, sizeof(dest));
+    std::memcpy(dest, utf8, length);
+}
+
+#if MA_LIVE_BUS_POSIX
+// Maps `name`, growing it to `bytes` if it is new. Two processes may race to
+// create the registry; the loser's ftruncate can fail (macOS sizes a segment
+// once), which is fine as long as the segment ends up large enough.
+void* mapShared(const char* name, size_t bytes, int flags)
+{
+    const int fd = shm_open(name, O_RDWR | flags, 0600);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info{};
+    bool sized = fstat(fd, &info) == 0 && (size_t) info.st_size >= bytes;
+    if (! sized)
+        sized = ftruncate(fd, (off_t) bytes) == 0 || (fstat(fd, &info) == 0 && (size_t) info.st_size >= bytes);
+
+    void* base = sized ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    return base == MAP_FAILED ? nullptr : base;
+}
+
+bool processIsGone(uint32_t pid)
+{
+    return pid != 0 && kill((pid_t) pid, 0) != 0 && errno == ESRCH;
+}
+
+juce::String segmentNameFor(uint32_t pid, int slotIndex)
+{
+    return juce::String(kSegmentPrefix) + juce::String(pid) + "_" + juce::String(slotIndex);
+}
+
+// Opening takes microseconds, so a slot still claiming after this long was
+// abandoned by an owner that died mid-open.
+constexpr uint64_t kClaimTimeoutNs = 10ull * 1000 * 1000 * 1000;
+
+// A claim belongs to whoever moves the slot heartbeat from the value it read to
+// its own timestamp, so two openers reclaiming one slot can never both win. The
+// pid goes in at once: a claim abandoned by a crash is then reclaimable like a
+// published slot.
+bool stampClaim(RegistrySlot& slot, uint64_t seenHeartbeatNs)
+{
+    if (! slot.heartbeatNs.compare_exchange_strong(seenHeartbeatNs, unixTimeNs(), std::memory_order_acq_rel))
+        return false;
+    if ((slot.seq.load(std::memory_order_relaxed) & 1u) != 0)
+        slot.seq.fetch_add(1, std::memory_order_relaxed); // the previous owner died mid-write
+    beginWrite(slot.seq);
+    slot.pid = (uint32_t) getpid();
+    std::memset(slot.segmentName, 0, sizeof(slot.segmentName));
+    endWrite(slot.seq);
+    return true;
+}
+
+// Reclaims an active slot whose owner has died (crash, killed host), removing
+// the segment it left behind.
+bool reclaimStaleSlot(RegistrySlot& slot, uint64_t seenHeartbeatNs)
+{
+    uint32_t pid = 0;
+    char staleName[kSegmentNameBytes]{};
+    if (! readConsistent(slot.seq, [&] { pid = slot.pid; std::memcpy(staleName, slot.segmentName, sizeof(staleName)); }))
+        return false;
+    if (! processIsGone(pid))
+        return false;
+
+    auto expected = (uint32_t) kSlotActive;
+    if (! slot.state.compare_exchange_strong(expected, kSlotClaiming, std::memory_order_acq_rel)
+        || ! stampClaim(slot, seenHeartbeatNs))
+        return false;
+    staleName[kSegmentNameBytes - 1] = '\0';
+    if (staleName[0] == '/')
+        shm_unlink(staleName);
+    return true;
+}
+
+// Reclaims a slot left in kSlotClaiming: its claimant is gone, or the claim has
+// outlived kClaimTimeoutNs (a crash before the pid was stamped, a recycled pid).
+// The claimant may already have created its segment, so that is removed too.
+bool reclaimAbandonedClaim(RegistrySlot& slot, int slotIndex, uint64_t seenHeartbeatNs)
+{
+    uint32_t pid = 0;
+    const bool pidKnown = readConsistent(slot.seq, [&] { pid = slot.pid; });
+    const auto nowNs = unixTimeNs();
+    const bool timedOut = nowNs > seenHeartbeatNs && nowNs - seenHeartbeatNs > kClaimTimeoutNs;
+    if (! timedOut && ! (pidKnown && processIsGone(pid)))
+        return false;
+
+    if (! stampClaim(slot, seenHeartbeatNs))
+        return false;
+    if (pidKnown && pid != 0)
+        shm_unlink(segmentNameFor(pid, slotIndex).toRawUTF8());
+    return true;
+}
+
+bool claimSlot(RegistrySlot& slot, int slotIndex)
+{
+    // Read first: the heartbeat of a free slot does not move, so a claim that
+    // raced ours fails its stamp instead of sharing the slot.
+    const auto seenHeartbeatNs = slot.heartbeatNs.load(std::memory_order_acquire);
+    auto state = (uint32_t) kSlotFree;
+    if (slot.state.compare_exchange_strong(state, kSlotClaiming, std::memory_order_acq_rel))
+        return stampClaim(slot, seenHeartbeatNs);
+    if (state == kSlotActive)
+        return reclaimStaleSlot(slot, seenHeartbeatNs);
+    if (state == kSlotClaiming)
+        return reclaimAbandonedClaim(slot, slotIndex, seenHeartbeatNs);
+    return false;
+}
+#endif
+} // namespace
+
+LiveFeatureBus::~LiveFeatureBus()
+{
+    close();
+}
+
+bool LiveFeatureBus::open(bool spectralEnabled)
+{
+    close();
+#if MA_LIVE_BUS_POSIX
+    registryBase = mapShared(kRegistryName, kRegistryBytes, O_CREAT);
+    if (registryBase == nullptr)
+        return false;
+
+    auto* registry = static_cast<RegistryHeader*>(registryBase);
+    if (std::memcmp(registry->magic, kRegistryMagic, sizeof(kRegistryMagic)) != 0 || registry->version != kVersion)
+    {
+        // New registry (zero-filled by ftruncate). Concurrent initialisers write the same values.
+        registry->version = kVersion;
+        registry->headerBytes = (uint32_t) sizeof(RegistryHeader);
+        registry->slotBytes = (uint32_t) sizeof(RegistrySlot);
+        registry->numSlots = (uint32_t) kRegistrySlots;
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(registry->magic, kRegistryMagic, sizeof(kRegistryMagic));
+    }
+
+    auto* slots = reinterpret_cast<RegistrySlot*>(static_cast<char*>(registryBase) + sizeof(RegistryHeader));
+    int slotIndex = -1;
+    for (int i = 0; i < kRegistrySlots && slotIndex < 0; ++i)
+        if (claimSlot(slots[i], i))
+            slotIndex = i;
+    if (slotIndex < 0)
+    {
+        munmap(registryBase, kRegistryBytes);
+        registryBase = nullptr;
+        return false;
+    }
+    registrySlot = &slots[slotIndex];
+
+    const auto pid = (uint32_t) getpid();
+    segmentName = segmentNameFor(pid, slotIndex);
+    shm_unlink(segmentName.toRawUTF8()); // leftover from a crashed process with a recycled pid
+    segment = static_cast<SegmentHeader*>(mapShared(segmentName.toRawUTF8(), kSegmentBytes, O_CREAT | O_EXCL));
+    if (segment == nullptr)
+    {
+        releaseRegistrySlot();
+        segmentName.clear();
+        return false;
+    }
+
+    // Fresh segments are zero-filled, so every ring stamp already reads "empty".
+    segment->version = kVersion;
+    segment->headerBytes = (uint32_t) kSegmentHeaderBytes;
+    segment->pointBytes = (uint32_t) sizeof(LivePoint);
+    segment->ringCapacity = kRingCapacity;
+    segment->pid = pid;
+    segment->flags = spectralEnabled ? kFlagSpectral : 0u;
+    segment->heartbeatNs.store(unixTimeNs(), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(segment->magic, kSegmentMagic, sizeof(kSegmentMagic));
+
+    nextTimelineIndex = 0;
+    pointsWritten = 0;
+    generation = 0;
+    haveTimelineGeneration = false;
+
+    beginWrite(registrySlot->seq);
+    registrySlot->pid = pid;
+    std::memset(registrySlot->segmentName, 0, sizeof(registrySlot->segmentName));
+    segmentName.copyToUTF8(registrySlot->segmentName, sizeof(registrySlot->segmentName));
+    copyId(registrySlot->trackId, trackId);
+    copyId(registrySlot->sessionId, sessionId);
+    endWrite(registrySlot->seq);
+    registrySlot->heartbeatNs.store(unixTimeNs(), std::memory_order_relaxed);
+    registrySlot->state.store(kSlotActive, std::memory_order_release);
+    return true;
+#else
+    juce::ignoreUnused(spectralEnabled);
+    return false;
+#endif
+}
+
+void LiveFeatureBus::close()
+{
+#if MA_LIVE_BUS_POSIX
+    if (segment != nullptr)
+    {
+        munmap(segment, kSegmentBytes);
+        shm_unlink(segmentName.toRawUTF8());
+        segment = nullptr;
+    }
+    releaseRegistrySlot();
+#endif
+    segmentName.clear();
+}
+
+void LiveFeatureBus::releaseRegistrySlot()
+{
+#if MA_LIVE_BUS_POSIX
+    if (registrySlot != nullptr)
+    {
+        beginWrite(registrySlot->seq);
+        registrySlot->pid = 0;
+        std::memset(registrySlot->segmentName, 0, sizeof(registrySlot->segmentName));
+        endWrite(registrySlot->seq);
+        registrySlot->state.store(kSlotFree, std::memory_order_release);
+        registrySlot = nullptr;
+    }
+    if (registryBase != nullptr)
+    {
+        munmap(registryBase, kRegistryBytes);
+        registryBase = nullptr;
+    }
+#endif
+}
+
+void LiveFeatureBus::setIdentity(const juce::String& newTrackId, const juce::String& newSessionId)
+{
+    trackId = newTrackId;
+    sessionId = newSessionId;
+    if (registrySlot != nullptr)
+        writeRegistryIdentity();
+}
+
+void LiveFeatureBus::writeRegistryIdentity()
+{
+    beginWrite(registrySlot->seq);
+    copyId(registrySlot->trackId, trackId);
+    copyId(registrySlot->sessionId, sessionId);
+    endWrite(registrySlot->seq);
+}
+
+void LiveFeatureBus::publish(const TimelineStore& timeline, const GlobalFeatures& global, double sampleRate)
+{
+    if (segment == nullptr)
+        return;
+
+    // The collector was reset (prepare / transport restart): times start over.
+    const auto first = timeline.firstRetainedIndex();
+    const auto end = first + (int64_t) timeline.size();
+    if (haveTimelineGeneration && timeline.generation() != timelineGeneration)
+    {
+        ++generation;
+        nextTimelineIndex = 0;
+    }
+    timelineGeneration = timeline.generation();
+    haveTimelineGeneration = true;
+
+    // Only the newest ringCapacity points can survive in the ring anyway.
+    const auto start = std::max({ nextTimelineIndex, first, end - (int64_t) kRingCapacity });
+    for (auto index = start; index < end; ++index)
+        publishPoint(timeline[(size_t) (index - first)]);
+    nextTimelineIndex = end;
+    segment->pointsWritten.store(pointsWritten, std::memory_order_release);
+
+    beginWrite(segment->seq);
+    segment->generation = generation;
+    segment->sampleRate = sampleRate;
+    auto& a = segment->aggregates;
+    a.durationSec = global.durationSec;
+    a.integratedRmsDb = global.integratedRmsDb;
+    a.peakDb = global.peakDb;
+    a.crestDb = global.crestDb;
+    a.integratedLufs = global.integratedLufs;
+    a.maxMomentaryLufs = global.maxMomentaryLufs;
+    a.maxShortTermLufs = global.maxShortTermLufs;
+    a.truePeakDbtp = global.truePeakDbtp;
+    a.bpm = global.bpm;
+    a.bpmConfidence = global.bpmConfidence;
+    a.onsetRateHz = global.onsetRateHz;
+    a.onsetCount = global.onsetCount;
+    copyId(segment->trackId, trackId);
+    copyId(segment->sessionId, sessionId);
+    endWrite(segment->seq);
+
+    const auto now = unixTimeNs();
+    segment->heartbeatNs.store(now, std::memory_order_relaxed);
+    if (registrySlot != nullptr)
+        registrySlot->heartbeatNs.store(now, std::memory_order_relaxed);
+}
+
+void LiveFeatureBus::publishPoint(const TimelinePoint& point)
+{
+    auto* ring = reinterpret_cast<LivePoint*>(reinterpret_cast<char*>(segment) + kSegmentHeaderBytes);
+    auto& slot = ring[pointsWritten % kRingCapacity];
+
+    slot.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeSec = point.timeSec;
+    slot.rmsDb = point.rmsDb;
+    slot.peakDb = point.peakDb;
+    slot.momentaryLufs = point.momentaryLufs;
+    slot.shortTermLufs = point.shortTermLufs;
+    slot.spectralCentroidHz = point.spectral.centroidHz;
+    slot.spectralRolloffHz = point.spectral.rolloffHz;
+    slot.spectralFlux = point.spectral.flux;
+    slot.tempoBpm = point.tempoBpm;
+    static_assert(::kNumOctaveBands == ma::bus::kNumOctaveBands, "bus layout mirrors the octave bands");
+    std::copy(point.spectral.octaveBandDb.begin(), point.spectral.octaveBandDb.end(), slot.octaveBandDb);
+    slot.stamp.store(pointsWritten + 1, std::memory_order_release);
+    ++pointsWritten;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <ma/bus/LiveBusLayout.h>
+
+#include "FeatureTypes.h"
+#include "TimelineStore.h"
+
+// Publishes one instance's session aggregates and timeline tail into a named
+// shared-memory segment (layout: <ma/bus/LiveBusLayout.h>) and lists it in the
+// process-independent registry, so local tools can follow a session without
+// waiting for sidecar files. Writer-thread only; open/publish never block on
+// readers. POSIX shared memory (macOS, Linux); elsewhere open() returns false.
+class LiveFeatureBus
+{
+public:
+    LiveFeatureBus() = default;
+    ~LiveFeatureBus();
+
+    // Claims a registry slot and creates the instance segment. False if shared
+    // memory is unavailable (sandboxed host, registry full, unsupported OS).
+    bool open(bool spectralEnabled);
+    void close();
+    bool isOpen() const { return segment != nullptr; }
+
+    // Registry entry and header ids; truncated to ma::bus::kIdBytes - 1 bytes.
+    void setIdentity(const juce::String& trackId, const juce::String& sessionId);
+
+    // Copies timeline points pushed since the previous call into the ring, then
+    // the aggregates, and refreshes the heartbeat. A timeline whose generation
+    // changed (collector reset) starts a new bus generation.
+    void publish(const TimelineStore& timeline, const GlobalFeatures& global, double sampleRate);
+
+    juce::String getSegmentName() const { return segmentName; }
+
+private:
+    void publishPoint(const TimelinePoint& point);
+    void writeRegistryIdentity();
+    void releaseRegistrySlot();
+
+    ma::bus::SegmentHeader* segment{nullptr};
+    ma::bus::RegistrySlot* registrySlot{nullptr};
+    void* registryBase{nullptr};
+    juce::String segmentName;
+    juce::String trackId{"untitled"};
+    juce::String sessionId{"session"};
+    int64_t nextTimelineIndex{0};
+    uint64_t pointsWritten{0};
+    uint64_t generation{0};
+    uint64_t timelineGeneration{0};   // TimelineStore::generation() at the last publish
+    bool haveTimelineGeneration{false};
+};
@@ -0,0 +1,117 @@
+#include "LoudnessAggregator.h"
+
+#include <ma/dsp/KWeighting.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr double kNegInf = -std::numeric_limits<double>::infinity();
+
+double lufsToEnergy(double lufs)
+{
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
+} // namespace
+
+void LoudnessAggregator::prepare(double sampleRate)
+{
+    subBlockSamples = std::max<int64_t>(1, (int64_t) std::llround(0.1 * (sampleRate > 0.0 ? sampleRate : 48000.0)));
+    binEnergy.resize((size_t) kHistogramBins);
+    binCount.resize((size_t) kHistogramBins);
+    reset();
+}
+
+void LoudnessAggregator::reset()
+{
+    pendingEnergy = 0.0;
+    pendingSamples = 0;
+    subBlockMeans.fill(0.0);
+    ringHead = 0;
+    subBlocksSeen = 0;
+    momentary = shortTerm = maxMomentary = maxShortTerm = kNegInf;
+    std::fill(binEnergy.begin(), binEnergy.end(), 0.0);
+    std::fill(binCount.begin(), binCount.end(), 0);
+    gatedEnergySum = 0.0;
+    gatedBlocks = 0;
+}
+
+void LoudnessAggregator::ingest(double energy, int samples)
+{
+    if (samples <= 0)
+        return;
+
+    // Spread the frame evenly over the sub-blocks it covers.
+    const double energyPerSample = energy / (double) samples;
+    int64_t remaining = samples;
+    while (remaining > 0)
+    {
+        const auto take = std::min(remaining, subBlockSamples - pendingSamples);
+        pendingEnergy += energyPerSample * (double) take;
+        pendingSamples += take;
+        remaining -= take;
+
+        if (pendingSamples == subBlockSamples)
+            completeSubBlock();
+    }
+}
+
+void LoudnessAggregator::completeSubBlock()
+{
+    subBlockMeans[(size_t) ringHead] = pendingEnergy / (double) subBlockSamples;
+    ringHead = (ringHead + 1) % kSubBlocksShortTerm;
+    subBlocksSeen = std::min(subBlocksSeen + 1, kSubBlocksShortTerm);
+    pendingEnergy = 0.0;
+    pendingSamples = 0;
+
+    if (subBlocksSeen >= kSubBlocksMomentary)
+    {
+        momentary = windowLufs(kSubBlocksMomentary);
+        maxMomentary = std::max(maxMomentary, momentary);
+
+        // Every 100 ms hop closes a 400 ms gating block.
+        if (momentary > kAbsoluteGateLufs && ! binCount.empty())
+        {
+            const double blockEnergy = lufsToEnergy(momentary);
+            const auto bin = std::clamp((int) ((momentary - kHistogramMinLufs) / kHistogramStepLu), 0, kHistogramBins - 1);
+            binEnergy[(size_t) bin] += blockEnergy;
+            ++binCount[(size_t) bin];
+            gatedEnergySum += blockEnergy;
+            ++gatedBlocks;
+        }
+    }
+
+    if (subBlocksSeen >= kSubBlocksShortTerm)
+    {
+        shortTerm = windowLufs(kSubBlocksShortTerm);
+        maxShortTerm = std::max(maxShortTerm, shortTerm);
+    }
+}
+
+double LoudnessAggregator::windowLufs(int numSubBlocks) const
+{
+    double sum = 0.0;
+    for (int i = 1; i <= numSubBlocks; ++i)
+        sum += subBlockMeans[(size_t) ((ringHead - i + kSubBlocksShortTerm) % kSubBlocksShortTerm)];
+    return ma::dsp::energyToLufs(sum / (double) numSubBlocks);
+}
+
+double LoudnessAggregator::integratedLufs() const
+{
+    if (gatedBlocks == 0)
+        return kNegInf;
+
+    const double relativeGate = ma::dsp::energyToLufs(gatedEnergySum / (double) gatedBlocks) + kRelativeGateLu;
+    const auto firstBin = std::clamp((int) std::ceil((relativeGate - kHistogramMinLufs) / kHistogramStepLu), 0, kHistogramBins);
+
+    double energy = 0.0;
+    int64_t count = 0;
+    for (int bin = firstBin; bin < kHistogramBins; ++bin)
+    {
+        energy += binEnergy[(size_t) bin];
+        count += binCount[(size_t) bin];
+    }
+    return count > 0 ? ma::dsp::energyToLufs(energy / (double) count) : kNegInf;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Collector-side half of the BS.1770 / EBU R128 loudness engine. The audio
+// thread K-weights each block (ma::dsp::KWeightingFilterBank) and ships the
+// block energy in ProbeFrame; this class rebuilds 100 ms sub-blocks from those
+// energies and derives momentary (400 ms), short-term (3 s) and gated
+// integrated loudness. Gating uses an energy histogram (0.1 LU bins), so
+// memory is constant for any session length. Frames that straddle a
+// sub-block boundary are split pro rata, so resolution is exact for blocks
+// up to 100 ms and smoothed beyond that.
+class LoudnessAggregator
+{
+public:
+    void prepare(double sampleRate);
+    void reset();
+
+    // energy: sum over the block of sum_ch(G_ch * y_ch^2); samples: per channel.
+    void ingest(double energy, int samples);
+
+    double momentaryLufs() const { return momentary; }
+    double shortTermLufs() const { return shortTerm; }
+    double maxMomentaryLufs() const { return maxMomentary; }
+    double maxShortTermLufs() const { return maxShortTerm; }
+    double integratedLufs() const; // -inf until one 400 ms block passes the gates
+
+private:
+    static constexpr int kSubBlocksMomentary = 4;   // 4 x 100 ms
+    static constexpr int kSubBlocksShortTerm = 30;  // 30 x 100 ms
+    static constexpr double kAbsoluteGateLufs = -70.0;
+    static constexpr double kRelativeGateLu = -10.0;
+    static constexpr double kHistogramMinLufs = -70.0;
+    static constexpr double kHistogramMaxLufs = 10.0;
+    static constexpr double kHistogramStepLu = 0.1;
+    static constexpr int kHistogramBins = 800;
+
+    void completeSubBlock();
+    double windowLufs(int numSubBlocks) const;
+
+    int64_t subBlockSamples{4800};
+    double pendingEnergy{0.0};
+    int64_t pendingSamples{0};
+
+    std::array<double, kSubBlocksShortTerm> subBlockMeans{}; // ring of mean squares
+    int ringHead{0};
+    int subBlocksSeen{0};
+
+    double momentary{-std::numeric_limits<double>::infinity()};
+    double shortTerm{-std::numeric_limits<double>::infinity()};
+    double maxMomentary{-std::numeric_limits<double>::infinity()};
+    double maxShortTerm{-std::numeric_limits<double>::infinity()};
+
+    // Gating histogram over 400 ms momentary blocks (75 % overlap); sized by
+    // prepare(), so an unprepared aggregator never gates.
+    std::vector<double> binEnergy;
+    std::vector<int64_t> binCount;
+    double gatedEnergySum{0.0}; // blocks above the absolute gate
+    int64_t gatedBlocks{0};
+};
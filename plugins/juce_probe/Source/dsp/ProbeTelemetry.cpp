@@ -0,0 +1,108 @@
+#include "ProbeTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+
+double ProbeTelemetry::bucketUpperPct(int index) noexcept
+{
+    const int octave = index / kSubBuckets;
+    const int sub = index % kSubBuckets;
+    return kMinLoadPct * std::ldexp(1.0 + (double) (sub + 1) / kSubBuckets, octave);
+}
+
+int ProbeTelemetry::bucketFor(double loadPct) noexcept
+{
+    if (! (loadPct > kMinLoadPct))
+        return 0;
+    // frexp: loadPct / kMinLoadPct = m * 2^e with m in [0.5, 1); the exponent picks
+    // the octave and the top mantissa bits the linear sub-bucket (HDR layout).
+    int exponent = 0;
+    const double mantissa = std::frexp(loadPct / kMinLoadPct, &exponent);
+    const int octave = exponent - 1;
+    const int sub = std::min(kSubBuckets - 1, (int) ((mantissa - 0.5) * 2.0 * kSubBuckets));
+    return std::clamp(octave * kSubBuckets + sub, 0, kNumBuckets - 1);
+}
+
+void ProbeTelemetry::reset() noexcept
+{
+    for (auto& b : buckets)
+        b.store(0, std::memory_order_relaxed);
+    blocks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    loadSumPct.store(0.0, std::memory_order_relaxed);
+    loadMaxPct.store(0.0, std::memory_order_relaxed);
+    fifoHighWater.store(0, std::memory_order_relaxed);
+    snapshotWrites.store(0, std::memory_order_relaxed);
+    lastWriteMs.store(0.0, std::memory_order_relaxed);
+    maxWriteMs.store(0.0, std::memory_order_relaxed);
+}
+
+void ProbeTelemetry::recordBlock(double elapsedSec, int numSamples, double sampleRate) noexcept
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    const double loadPct = 100.0 * elapsedSec * sampleRate / (double) numSamples;
+    bump(buckets[(size_t) bucketFor(loadPct)]);
+    bump(blocks);
+    if (loadPct > 100.0)
+        bump(overruns);
+    bump(loadSumPct, loadPct);
+    if (loadPct > loadMaxPct.load(std::memory_order_relaxed))
+        loadMaxPct.store(loadPct, std::memory_order_relaxed);
+}
+
+void ProbeTelemetry::recordFifoFill(int numReady, int capacity) noexcept
+{
+    fifoCapacity.store(capacity, std::memory_order_relaxed);
+    if (numReady > fifoHighWater.load(std::memory_order_relaxed))
+        fifoHighWater.store(numReady, std::memory_order_relaxed);
+}
+
+void ProbeTelemetry::recordSnapshotWrite(double elapsedMs) noexcept
+{
+    bump(snapshotWrites);
+    lastWriteMs.store(elapsedMs, std::memory_order_relaxed);
+    if (elapsedMs > maxWriteMs.load(std::memory_order_relaxed))
+        maxWriteMs.store(elapsedMs, std::memory_order_relaxed);
+}
+
+ProbeTelemetry::Report ProbeTelemetry::report() const noexcept
+{
+    Report r;
+    int64_t binned = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        r.histogram[i] = buckets[i].load(std::memory_order_relaxed);
+        binned += r.histogram[i];
+    }
+    r.blocks = blocks.load(std::memory_order_relaxed);
+    r.deadlineOverruns = overruns.load(std::memory_order_relaxed);
+    r.meanLoadPct = r.blocks > 0 ? loadSumPct.load(std::memory_order_relaxed) / (double) r.blocks : 0.0;
+    r.maxLoadPct = loadMaxPct.load(std::memory_order_relaxed);
+
+    // Percentiles from the histogram (upper bucket edge, capped at the observed max).
+    const auto percentile = [&](double q)
+    {
+        if (binned <= 0)
+            return 0.0;
+        const auto rank = (int64_t) std::ceil(q * (double) binned);
+        int64_t seen = 0;
+        for (int i = 0; i < kNumBuckets; ++i)
+        {
+            seen += r.histogram[(size_t) i];
+            if (seen >= rank)
+                return std::min(bucketUpperPct(i), r.maxLoadPct);
+        }
+        return r.maxLoadPct;
+    };
+    r.p50LoadPct = percentile(0.50);
+    r.p99LoadPct = percentile(0.99);
+
+    r.fifoHighWater = fifoHighWater.load(std::memory_order_relaxed);
+    r.fifoCapacity = fifoCapacity.load(std::memory_order_relaxed);
+    r.snapshotWrites = snapshotWrites.load(std::memory_order_relaxed);
+    r.lastSnapshotWriteMs = lastWriteMs.load(std::memory_order_relaxed);
+    r.maxSnapshotWriteMs = maxWriteMs.load(std::memory_order_relaxed);
+    return r;
+}
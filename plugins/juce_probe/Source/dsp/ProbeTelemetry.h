@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Per-instance hot-path counters, so a field report can say whether the probe
+// was behind a glitch. Every counter has a single writer (audio thread for
+// block load and FIFO fill, writer thread for snapshot writes) and is published
+// with relaxed load+store pairs, never read-modify-write; readers on any thread
+// may see a slightly stale but never torn value.
+//
+// Block load is processBlock time as a percentage of the block's real-time
+// deadline (numSamples / sampleRate), binned in an HDR-style log-linear
+// histogram: kSubBuckets per octave from kMinLoadPct up, so relative precision
+// is ~1/kSubBuckets across five decades without per-sample cost.
+class ProbeTelemetry
+{
+public:
+    static constexpr int kSubBuckets = 4;
+    static constexpr int kOctaves = 16;                 // kMinLoadPct .. ~4000%
+    static constexpr int kNumBuckets = kSubBuckets * kOctaves;
+    static constexpr double kMinLoadPct = 0.0625;
+
+    struct Report
+    {
+        int64_t blocks{0};
+        int64_t deadlineOverruns{0};                    // blocks over 100% load
+        double meanLoadPct{0.0};
+        double p50LoadPct{0.0};
+        double p99LoadPct{0.0};
+        double maxLoadPct{0.0};
+        std::array<int64_t, kNumBuckets> histogram{};
+        int fifoHighWater{0};
+        int fifoCapacity{0};
+        int64_t snapshotWrites{0};
+        double lastSnapshotWriteMs{0.0};
+        double maxSnapshotWriteMs{0.0};
+    };
+
+    // Upper edge (load %) of histogram bucket `index`.
+    static double bucketUpperPct(int index) noexcept;
+
+    // Message thread, audio stopped.
+    void reset() noexcept;
+
+    // Audio thread.
+    void recordBlock(double elapsedSec, int numSamples, double sampleRate) noexcept;
+    void recordFifoFill(int numReady, int capacity) noexcept;
+
+    // Writer thread (or the inline caller).
+    void recordSnapshotWrite(double elapsedMs) noexcept;
+
+    // Any thread.
+    Report report() const noexcept;
+
+private:
+    static int bucketFor(double loadPct) noexcept;
+
+    template <typename T>
+    static void bump(std::atomic<T>& counter, T by = T(1)) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    // Audio thread writes.
+    alignas(64) std::array<std::atomic<int64_t>, kNumBuckets> buckets{};
+    std::atomic<int64_t> blocks{0};
+    std::atomic<int64_t> overruns{0};
+    std::atomic<double> loadSumPct{0.0};
+    std::atomic<double> loadMaxPct{0.0};
+    std::atomic<int> fifoHighWater{0};
+    std::atomic<int> fifoCapacity{0};
+
+    // Writer thread writes.
+    alignas(64) std::atomic<int64_t> snapshotWrites{0};
+    std::atomic<double> lastWriteMs{0.0};
+    std::atomic<double> maxWriteMs{0.0};
+};
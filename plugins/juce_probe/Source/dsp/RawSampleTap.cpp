@@ -0,0 +1,74 @@
+#include "RawSampleTap.h"
+
+#include <cmath>
+#include <cstring>
+
+void RawSampleTap::prepare(bool enabled, double sampleRate, int maxBlockSize, int numChannels,
+                           double bufferSeconds)
+{
+    channelCount = enabled ? juce::jlimit(0, kMaxChannels, numChannels) : 0;
+    if (channelCount == 0)
+    {
+        capacity = 0;
+        planeSize = 0;
+        storage.clear();
+        storage.shrink_to_fit();
+        fifo.setTotalSize(1);
+        reset();
+        return;
+    }
+
+    const auto wanted = juce::jmax((int) std::ceil(sampleRate * bufferSeconds), 8 * juce::jmax(1, maxBlockSize));
+    capacity = juce::nextPowerOfTwo(wanted);
+    // AbstractFifo keeps one slot free, so size it one larger to expose `capacity`.
+    // Its indices run to `capacity` inclusive, so each plane is one slot larger too.
+    planeSize = capacity + 1;
+    storage.assign((size_t) planeSize * (size_t) channelCount, 0.0f);
+    fifo.setTotalSize(planeSize);
+    reset();
+}
+
+void RawSampleTap::reset()
+{
+    fifo.reset();
+    overrunSamples.store(0, std::memory_order_relaxed);
+    overrunEvents.store(0, std::memory_order_relaxed);
+}
+
+int RawSampleTap::write(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (channelCount == 0 || numSamples <= 0)
+        return 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int ch = 0; ch < channelCount; ++ch)
+    {
+        auto* dest = storage.data() + (size_t) ch * (size_t) planeSize;
+        // Channels the host did not provide this block read as silence.
+        if (ch < numChannels && channels[ch] != nullptr)
+        {
+            if (size1 > 0)
+                std::memcpy(dest + start1, channels[ch], (size_t) size1 * sizeof(float));
+            if (size2 > 0)
+                std::memcpy(dest + start2, channels[ch] + size1, (size_t) size2 * sizeof(float));
+        }
+        else
+        {
+            std::memset(dest + start1, 0, (size_t) size1 * sizeof(float));
+            std::memset(dest + start2, 0, (size_t) size2 * sizeof(float));
+        }
+    }
+
+    const int written = size1 + size2;
+    if (written > 0)
+        fifo.finishedWrite(written);
+
+    const int dropped = numSamples - written;
+    if (dropped > 0)
+    {
+        overrunSamples.store(overrunSamples.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+        overrunEvents.store(overrunEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    return dropped;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Optional single-producer/single-consumer ring of raw planar sample blocks,
+// from processBlock to the collector thread, for stages that need real samples
+// (spectra, onsets). The audio thread copies each channel with memcpy (two at
+// the ring's wrap point); the consumer reads the ready spans in place. Samples
+// that do not fit are dropped and counted, never blocked on. Disabled (no
+// storage, write() is a branch) unless prepare() is called with enabled = true.
+class RawSampleTap
+{
+public:
+    static constexpr int kMaxChannels = 16;
+
+    // Message thread, audio stopped. Capacity covers `bufferSeconds` and at
+    // least eight host blocks.
+    void prepare(bool enabled, double sampleRate, int maxBlockSize, int numChannels,
+                 double bufferSeconds = 2.0);
+    void reset();
+
+    bool isEnabled() const noexcept { return channelCount > 0; }
+    int getNumChannels() const noexcept { return channelCount; }
+    int getCapacity() const noexcept { return capacity; }
+
+    // Audio thread. Returns the number of samples (per channel) dropped.
+    int write(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Consumer thread.
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+    // Consumer thread: calls fn(const float* const* channels, int numChannels,
+    // int numSamples) on each ready span in place (at most two), then releases
+    // them to the producer. Returns the number of samples consumed.
+    template <typename Fn>
+    int read(Fn&& fn)
+    {
+        const int numReady = fifo.getNumReady();
+        if (numReady <= 0)
+            return 0;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+        std::array<const float*, kMaxChannels> spans{};
+        const auto visit = [&](int start, int size)
+        {
+            if (size <= 0)
+                return;
+            for (int ch = 0; ch < channelCount; ++ch)
+                spans[(size_t) ch] = storage.data() + (size_t) ch * (size_t) planeSize + (size_t) start;
+            fn(spans.data(), channelCount, size);
+        };
+        visit(start1, size1);
+        visit(start2, size2);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    // Any thread.
+    int64_t getOverrunSamples() const noexcept { return overrunSamples.load(std::memory_order_relaxed); }
+    int64_t getOverrunEvents() const noexcept { return overrunEvents.load(std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo{1};
+    std::vector<float> storage; // planar: channel ch at [ch * planeSize, (ch + 1) * planeSize)
+    int capacity{0};            // usable samples per channel
+    int planeSize{0};           // capacity + 1, the FIFO's index range
+    int channelCount{0};
+    // Written only by the audio thread.
+    alignas(64) std::atomic<int64_t> overrunSamples{0};
+    std::atomic<int64_t> overrunEvents{0};
+};
@@ -0,0 +1,106 @@
+#include "SidecarSchema.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace
+{
+// Omitted entirely when the spectral stage is off or had no hops yet.
+void writeSpectral(JsonStreamWriter& json, const SpectralFeatures& spectral)
+{
+    if (! spectral.isValid())
+        return;
+
+    json.field("spectral_centroid_hz", spectral.centroidHz);
+    json.field("spectral_rolloff_hz", spectral.rolloffHz);
+    json.field("spectral_flux", spectral.flux);
+    json.beginArray("octave_band_db");
+    for (const auto band : spectral.octaveBandDb)
+        json.value(band);
+    json.endArray();
+}
+
+// NaN (an empty bin) is written as null.
+float linearToDb(float linear)
+{
+    return linear >= 0.0f ? juce::Decibels::gainToDecibels(linear, -200.0f) : linear;
+}
+} // namespace
+
+namespace SidecarSchema
+{
+void writeMetadata(JsonStreamWriter& json, const SnapshotRequest& request)
+{
+    json.field("version", kVersion);
+    json.field("track_id", request.trackId);
+    json.field("session_id", request.sessionId);
+    json.field("host", request.hostName);
+    json.field("sample_rate", request.sampleRate);
+    json.field("build", request.buildId);
+}
+
+void writeGlobal(JsonStreamWriter& json, const GlobalFeatures& global)
+{
+    json.field("duration_sec", global.durationSec);
+    json.field("integrated_rms_db", global.integratedRmsDb);
+    json.field("peak_db", global.peakDb);
+    json.field("crest_factor_db", global.crestDb);
+    json.field("integrated_lufs", global.integratedLufs);
+    json.field("max_momentary_lufs", global.maxMomentaryLufs);
+    json.field("max_short_term_lufs", global.maxShortTermLufs);
+    json.field("true_peak_dbtp", global.truePeakDbtp);
+    writeSpectral(json, global.spectral);
+    if (global.spectral.isValid())
+    {
+        json.field("bpm", global.bpm);
+        json.field("bpm_confidence", global.bpmConfidence);
+        json.field("onset_count", global.onsetCount);
+        json.field("onset_rate_hz", global.onsetRateHz);
+    }
+}
+
+void writeTimelinePoint(JsonStreamWriter& json, const TimelinePoint& point)
+{
+    json.field("time_sec", point.timeSec);
+    json.field("rms_db", point.rmsDb);
+    json.field("peak_db", point.peakDb);
+    json.field("momentary_lufs", point.momentaryLufs);
+    json.field("short_term_lufs", point.shortTermLufs);
+    writeSpectral(json, point.spectral);
+    if (point.spectral.isValid())
+        json.field("tempo_bpm", point.tempoBpm);
+}
+
+void writePyramidLevel(JsonStreamWriter& json, const TimelinePyramid& pyramid, int level)
+{
+    const auto first = pyramid.firstBin(level);
+    const auto end = pyramid.endBin(level);
+    const auto column = [&](const char* key, auto&& valueOf)
+    {
+        json.beginArray(key);
+        for (auto i = first; i < end; ++i)
+            json.value(valueOf(pyramid.bin(level, i)));
+        json.endArray();
+    };
+
+    json.beginObject();
+    json.field("bin_sec", TimelinePyramid::binSeconds(level));
+    json.field("start_sec", (double) first * TimelinePyramid::binSeconds(level));
+    column("rms_db", [](const TimelinePyramid::Bin& b) { return linearToDb(std::sqrt(b.meanSquare)); });
+    column("rms_min_db", [](const TimelinePyramid::Bin& b) { return linearToDb(b.rmsMin); });
+    column("rms_max_db", [](const TimelinePyramid::Bin& b) { return linearToDb(b.rmsMax); });
+    column("peak_db", [](const TimelinePyramid::Bin& b) { return linearToDb(b.peak); });
+    json.endObject();
+}
+
+uint32_t parsePyramidLevels(const juce::String& spec)
+{
+    if (spec.trim().equalsIgnoreCase("all"))
+        return (1u << TimelinePyramid::kNumLevels) - 1u;
+
+    uint32_t levels = 0;
+    for (const auto& token : juce::StringArray::fromTokens(spec, ",", ""))
+        if (const auto level = TimelinePyramid::levelForBinSeconds(token.trim().getDoubleValue()); level >= 0)
+            levels |= 1u << level;
+    return levels;
+}
+} // namespace SidecarSchema
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "FeatureTypes.h"
+#include "JsonStreamWriter.h"
+#include "TimelinePyramid.h"
+
+// Field layout of juce_probe_features_v1, shared by the snapshot and live writers
+// so both stay in step when features are added.
+namespace SidecarSchema
+{
+constexpr const char* kVersion = "juce_probe_features_v1";
+
+// version, track/session ids, host, sample rate, build.
+void writeMetadata(JsonStreamWriter& json, const SnapshotRequest& request);
+void writeGlobal(JsonStreamWriter& json, const GlobalFeatures& global);
+void writeTimelinePoint(JsonStreamWriter& json, const TimelinePoint& point);
+
+// One "pyramid" entry: the level's retained bins as column arrays (dB, null = no audio).
+void writePyramidLevel(JsonStreamWriter& json, const TimelinePyramid& pyramid, int level);
+
+// Comma-separated bin widths in seconds ("0.01,1") or "all" -> SnapshotRequest::pyramidLevels.
+// Widths that are not a pyramid level are ignored.
+uint32_t parsePyramidLevels(const juce::String& spec);
+} // namespace SidecarSchema
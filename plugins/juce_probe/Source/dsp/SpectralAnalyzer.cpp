@@ -0,0 +1,260 @@
+#include "SpectralAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+constexpr double kRolloffFraction = 0.85;
+constexpr float kLogCompression = 100.0f; // log1p(gamma * |X|) before differencing, for flux
+constexpr double kPowerFloor = 1.0e-12;
+constexpr int kMaxCreditHops = 64;        // burst allowance: at most 64 hops of saved-up budget
+
+// Octave band n has centre 31.25 * 2^n Hz (nominal 31.5 .. 16k) and edges at centre / sqrt2, centre * sqrt2.
+double bandCentreHz(int band)
+{
+    return 31.25 * std::pow(2.0, (double) band);
+}
+} // namespace
+
+void SpectralAnalyzer::Accumulator::clear()
+{
+    centroid = rolloff = flux = 0.0;
+    bands.fill(0.0);
+    hops = 0;
+    fluxHops = 0;
+}
+
+SpectralFeatures SpectralAnalyzer::Accumulator::mean() const
+{
+    SpectralFeatures features;
+    if (hops <= 0)
+        return features;
+
+    const auto n = (double) hops;
+    features.centroidHz = (float) (centroid / n);
+    features.rolloffHz = (float) (rolloff / n);
+    features.flux = fluxHops > 0 ? (float) (flux / (double) fluxHops) : 0.0f;
+    for (size_t b = 0; b < bands.size(); ++b)
+        features.octaveBandDb[b] = (float) (10.0 * std::log10(std::max(bands[b] / n, kPowerFloor)));
+    return features;
+}
+
+void SpectralAnalyzer::allocateBuffers()
+{
+    if (fft != nullptr)
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT>(kFftOrder);
+    window.resize((size_t) kFftSize);
+    input.resize((size_t) kFftSize);
+    fftBuffer.resize((size_t) kFftSize * 2);
+    logMagnitude.resize((size_t) kNumBins);
+    previousLogMagnitude.resize((size_t) kNumBins);
+    bandOfBin.resize((size_t) kNumBins);
+
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) kFftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann,
+                                                             false);
+    double windowPower = 0.0;
+    for (const auto w : window)
+        windowPower += (double) w * (double) w;
+
+    // One-sided Parseval: a full-scale sine then reads its mean square (-3 dB) across its band.
+    powerNormaliser = 2.0 / ((double) kFftSize * windowPower);
+}
+
+void SpectralAnalyzer::freeBuffers()
+{
+    fft.reset();
+    for (auto* buffer : { &window, &input, &fftBuffer, &logMagnitude, &previousLogMagnitude })
+        std::vector<float>().swap(*buffer);
+    std::vector<int>().swap(bandOfBin);
+}
+
+void SpectralAnalyzer::prepare(double newSampleRate, const Config& newConfig)
+{
+    config = newConfig;
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+    binHz = sampleRate / (double) kFftSize;
+
+    if (config.enabled)
+        allocateBuffers();
+    else
+        freeBuffers();
+
+    for (int bin = 0; bin < (int) bandOfBin.size(); ++bin)
+    {
+        const double hz = (double) bin * binHz;
+        int band = -1;
+        for (int b = 0; b < kNumOctaveBands; ++b)
+        {
+            const double centre = bandCentreHz(b);
+            if (hz >= centre / std::sqrt(2.0) && hz < centre * std::sqrt(2.0))
+            {
+                band = b;
+                break;
+            }
+        }
+        bandOfBin[(size_t) bin] = band;
+    }
+
+    const double hopSeconds = (double) kHopSize / sampleRate;
+    creditPerHop = config.cpuBudgetFraction > 0.0 ? hopSeconds * config.cpuBudgetFraction : 0.0;
+    maxCredit = creditPerHop * kMaxCreditHops;
+    reset();
+}
+
+void SpectralAnalyzer::reset()
+{
+    std::fill(input.begin(), input.end(), 0.0f);
+    std::fill(previousLogMagnitude.begin(), previousLogMagnitude.end(), 0.0f);
+    inputFill = 0;
+    samplesSinceHop = 0;
+    havePrevious = false;
+    credit = maxCredit;
+    point.clear();
+    session.clear();
+    hopsAnalysed = 0;
+    hopsSkipped = 0;
+}
+
+void SpectralAnalyzer::release()
+{
+    config.enabled = false;
+    freeBuffers();
+    reset();
+}
+
+void SpectralAnalyzer::process(const float* samples, int numSamples)
+{
+    if (! config.enabled || samples == nullptr)
+        return;
+
+    while (numSamples > 0)
+    {
+        // Consume up to the next hop boundary, sliding the window once it is full.
+        const int take = std::min(numSamples, kHopSize - samplesSinceHop);
+        if (inputFill + take > kFftSize)
+        {
+            const int shift = inputFill + take - kFftSize;
+            std::memmove(input.data(), input.data() + shift, sizeof(float) * (size_t) (inputFill - shift));
+            inputFill -= shift;
+        }
+        std::memcpy(input.data() + inputFill, samples, sizeof(float) * (size_t) take);
+        inputFill += take;
+        samplesSinceHop += take;
+        samples += take;
+        numSamples -= take;
+
+        if (samplesSinceHop < kHopSize)
+            continue;
+        samplesSinceHop = 0;
+        if (inputFill < kFftSize)
+            continue; // still priming the first window
+
+        if (creditPerHop <= 0.0 || ! budgetEnabled)
+        {
+            analyseHop();
+            continue;
+        }
+
+        credit = std::min(maxCredit, credit + creditPerHop);
+        if (credit <= 0.0)
+        {
+            ++hopsSkipped;
+            havePrevious = false; // flux would span the gap
+            if (hopListener != nullptr)
+                hopListener->spectralHopSkipped();
+            continue;
+        }
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        analyseHop();
+        credit -= juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+}
+
+void SpectralAnalyzer::analyseHop()
+{
+    for (int i = 0; i < kFftSize; ++i)
+        fftBuffer[(size_t) i] = input[(size_t) i] * window[(size_t) i];
+    std::fill(fftBuffer.begin() + kFftSize, fftBuffer.end(), 0.0f);
+    fft->performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+    double magnitudeSum = 0.0, weightedSum = 0.0;
+    std::array<double, kNumOctaveBands> bandPower{};
+    double fluxSum = 0.0;
+
+    for (int bin = 0; bin < kNumBins; ++bin)
+    {
+        const double magnitude = (double) fftBuffer[(size_t) bin];
+        const double power = magnitude * magnitude;
+        magnitudeSum += magnitude;
+        weightedSum += magnitude * (double) bin * binHz;
+        if (const int band = bandOfBin[(size_t) bin]; band >= 0)
+            bandPower[(size_t) band] += power;
+
+        const float logMag = std::log1p(kLogCompression * (float) magnitude);
+        fluxSum += std::max(0.0f, logMag - previousLogMagnitude[(size_t) bin]);
+        logMagnitude[(size_t) bin] = logMag;
+    }
+
+    double rolloffHz = 0.0;
+    if (magnitudeSum > 0.0)
+    {
+        const double target = kRolloffFraction * magnitudeSum;
+        double cumulative = 0.0;
+        for (int bin = 0; bin < kNumBins; ++bin)
+        {
+            cumulative += (double) fftBuffer[(size_t) bin];
+            if (cumulative >= target)
+            {
+                rolloffHz = (double) bin * binHz;
+                break;
+            }
+        }
+    }
+
+    const double centroidHz = magnitudeSum > 0.0 ? weightedSum / magnitudeSum : 0.0;
+    const double flux = fluxSum / (double) kNumBins;
+    const bool fluxValid = havePrevious;
+    std::swap(logMagnitude, previousLogMagnitude);
+    havePrevious = true;
+
+    if (hopListener != nullptr)
+    {
+        if (fluxValid)
+            hopListener->spectralHopAnalysed((float) flux);
+        else
+            hopListener->spectralHopSkipped();
+    }
+
+    for (auto* acc : { &point, &session })
+    {
+        acc->centroid += centroidHz;
+        acc->rolloff += rolloffHz;
+        if (fluxValid)
+        {
+            acc->flux += flux;
+            ++acc->fluxHops;
+        }
+        for (size_t b = 0; b < bandPower.size(); ++b)
+            acc->bands[b] += bandPower[b] * powerNormaliser;
+        ++acc->hops;
+    }
+    ++hopsAnalysed;
+}
+
+SpectralFeatures SpectralAnalyzer::takePointFeatures()
+{
+    const auto features = point.mean();
+    point.clear();
+    return features;
+}
+
+SpectralFeatures SpectralAnalyzer::sessionFeatures() const
+{
+    return session.mean();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "FeatureTypes.h"
+
+// Collector-side STFT stage: 2048-point Hann-windowed FFT (juce::dsp::FFT) at a
+// 512-sample hop over the mono mix, producing centroid, rolloff, flux and octave
+// band energies. The FFT and its buffers are allocated by prepare() only when the
+// stage is enabled (a disabled analyzer holds none); process() never allocates.
+//
+// CPU is capped per instance with a token bucket: each hop of audio earns
+// hopSeconds * cpuBudgetFraction of credit and each analysed hop spends its
+// measured cost. Hops that arrive with no credit are skipped (and counted), so
+// a busy collector thread degrades resolution instead of falling behind.
+class SpectralAnalyzer
+{
+public:
+    static constexpr int kFftOrder = 11;
+    static constexpr int kFftSize = 1 << kFftOrder;
+    static constexpr int kHopSize = kFftSize / 4;
+    static constexpr int kNumBins = kFftSize / 2 + 1;
+
+    // Collector thread: told about every hop in order, so downstream stages
+    // (TempoTracker) keep the hop time base even when the CPU budget skips one.
+    struct HopListener
+    {
+        virtual ~HopListener() = default;
+        virtual void spectralHopAnalysed(float flux) = 0;
+        virtual void spectralHopSkipped() = 0;
+    };
+
+    struct Config
+    {
+        bool enabled{false};
+        double cpuBudgetFraction{0.05}; // of one core, relative to real time; <= 0 means unlimited
+    };
+
+    void prepare(double sampleRate, const Config& config);
+    void reset();
+    // Frees the FFT and buffers and disables the stage until the next prepare().
+    void release();
+    bool isEnabled() const { return config.enabled; }
+    void setHopListener(HopListener* listener) { hopListener = listener; }
+    // Collector thread: false analyses every hop regardless of the CPU budget
+    // (offline renders). Kept across prepare().
+    void setBudgetEnabled(bool enabled) { budgetEnabled = enabled; }
+
+    // Collector thread: consumes mono samples, analysing each completed hop.
+    void process(const float* samples, int numSamples);
+
+    // Mean over the hops analysed since the previous call; resets that accumulator.
+    SpectralFeatures takePointFeatures();
+    // Mean over every hop analysed since reset().
+    SpectralFeatures sessionFeatures() const;
+
+    int64_t analysedHops() const { return hopsAnalysed; }
+    int64_t skippedHops() const { return hopsSkipped; }
+
+    double getHopSeconds() const { return (double) kHopSize / sampleRate; }
+
+private:
+    struct Accumulator
+    {
+        void clear();
+        SpectralFeatures mean() const;
+        double centroid{0.0}, rolloff{0.0}, flux{0.0};
+        std::array<double, kNumOctaveBands> bands{};
+        int hops{0};
+        int fluxHops{0};
+    };
+
+    void allocateBuffers();
+    void freeBuffers();
+    void analyseHop();
+
+    Config config;
+    HopListener* hopListener{nullptr};
+    double sampleRate{48000.0};
+    std::unique_ptr<juce::dsp::FFT> fft; // null while disabled
+    std::vector<float> window;
+    std::vector<float> input;       // last kFftSize samples, oldest first
+    std::vector<float> fftBuffer;   // 2 * kFftSize, as performFrequencyOnlyForwardTransform needs
+    std::vector<float> logMagnitude;
+    std::vector<float> previousLogMagnitude;
+    std::vector<int> bandOfBin;     // -1 outside the octave bands
+    int inputFill{0};
+    int samplesSinceHop{0};
+    bool havePrevious{false};
+    double powerNormaliser{1.0};
+    double binHz{0.0};
+
+    double credit{0.0};
+    double creditPerHop{0.0};
+    bool budgetEnabled{true};
+    double maxCredit{0.0};
+
+    Accumulator point;
+    Accumulator session;
+    int64_t hopsAnalysed{0};
+    int64_t hopsSkipped{0};
+};
@@ -0,0 +1,194 @@
+#include "TempoTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr double kMinBpm = 40.0;
+constexpr double kMaxBpm = 220.0;
+constexpr double kPriorBpm = 120.0;
+constexpr double kPriorOctaves = 1.0;     // std-dev of the log2-tempo prior
+constexpr double kMeanWindowSec = 0.5;    // flux detrending
+constexpr double kLocalWindowSec = 8.0;   // tempo curve memory
+constexpr double kOnsetPeakSec = 0.03;    // half-width of the onset peak picker
+constexpr double kOnsetMinGapSec = 0.05;
+constexpr double kOnsetThreshold = 1.5;   // times the running envelope mean
+constexpr double kMinSecondsForEstimate = 3.0; // two beats at the slowest tempo
+
+constexpr double kNoEstimate = std::numeric_limits<double>::quiet_NaN();
+} // namespace
+
+void TempoTracker::prepare(double hopSeconds)
+{
+    hopSec = hopSeconds > 0.0 ? hopSeconds : 512.0 / 48000.0;
+    const double hopsPerSec = 1.0 / hopSec;
+    minLag = std::max(1, (int) std::floor(60.0 / kMaxBpm * hopsPerSec));
+    maxLag = std::max(minLag + 2, (int) std::ceil(60.0 / kMinBpm * hopsPerSec));
+    peakHalfWidth = std::max(1, (int) std::lround(kOnsetPeakSec * hopsPerSec));
+    meanCoeff = std::exp(-hopSec / kMeanWindowSec);
+    localDecay = std::exp(-hopSec / kLocalWindowSec);
+
+    // History must cover the longest lag plus the onset look-ahead.
+    int64_t size = 1;
+    while (size < (int64_t) (maxLag + 2 * peakHalfWidth + 2))
+        size <<= 1;
+    history.assign((size_t) size, std::numeric_limits<float>::quiet_NaN());
+    historyMask = size - 1;
+
+    localAcf.assign((size_t) maxLag + 2, 0.0);
+    globalAcf.assign((size_t) maxLag + 2, 0.0);
+    prior.assign((size_t) maxLag + 2, 0.0);
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        const double bpm = 60.0 / ((double) lag * hopSec);
+        const double octaves = std::log2(bpm / kPriorBpm) / kPriorOctaves;
+        prior[(size_t) lag] = std::exp(-0.5 * octaves * octaves);
+    }
+    reset();
+}
+
+void TempoTracker::reset()
+{
+    std::fill(history.begin(), history.end(), std::numeric_limits<float>::quiet_NaN());
+    std::fill(localAcf.begin(), localAcf.end(), 0.0);
+    std::fill(globalAcf.begin(), globalAcf.end(), 0.0);
+    localEnergy = globalEnergy = 0.0;
+    numHops = validHops = 0;
+    fluxMean = envelopeMean = 0.0;
+    lastOnsetHop = -1;
+    onsets = 0;
+}
+
+void TempoTracker::spectralHopAnalysed(float flux)
+{
+    fluxMean = meanCoeff * fluxMean + (1.0 - meanCoeff) * (double) flux;
+    const auto envelope = (float) std::max(0.0, (double) flux - fluxMean);
+    envelopeMean = meanCoeff * envelopeMean + (1.0 - meanCoeff) * (double) envelope;
+    pushEnvelope(envelope, true);
+}
+
+void TempoTracker::spectralHopSkipped()
+{
+    pushEnvelope(0.0f, false);
+}
+
+float TempoTracker::historyAt(int64_t index) const
+{
+    return history[(size_t) (index & historyMask)];
+}
+
+void TempoTracker::pushEnvelope(float value, bool valid)
+{
+    if (history.empty())
+        return;
+
+    const int64_t now = numHops++;
+    history[(size_t) (now & historyMask)] = valid ? value : std::numeric_limits<float>::quiet_NaN();
+    if (! valid)
+        return;
+    ++validHops;
+
+    const double x = (double) value;
+    localEnergy = localDecay * localEnergy + x * x;
+    globalEnergy += x * x;
+
+    const int lagLimit = (int) std::min<int64_t>(maxLag, now);
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        double product = 0.0;
+        if (lag <= lagLimit)
+        {
+            const float past = historyAt(now - lag);
+            if (! std::isnan(past))
+                product = x * (double) past;
+        }
+        localAcf[(size_t) lag] = localDecay * localAcf[(size_t) lag] + product;
+        globalAcf[(size_t) lag] += product;
+    }
+
+    detectOnset();
+}
+
+void TempoTracker::detectOnset()
+{
+    // The candidate sits peakHalfWidth hops back so the window has look-ahead.
+    const int64_t candidate = numHops - 1 - peakHalfWidth;
+    if (candidate < peakHalfWidth)
+        return;
+
+    const float value = historyAt(candidate);
+    if (std::isnan(value) || (double) value <= kOnsetThreshold * envelopeMean || value <= 0.0f)
+        return;
+
+    for (int64_t i = candidate - peakHalfWidth; i <= candidate + peakHalfWidth; ++i)
+    {
+        const float other = historyAt(i);
+        if (i != candidate && ! std::isnan(other) && other > value)
+            return;
+    }
+
+    const auto minGapHops = (int64_t) std::ceil(kOnsetMinGapSec / hopSec);
+    if (lastOnsetHop >= 0 && candidate - lastOnsetHop < minGapHops)
+        return;
+
+    lastOnsetHop = candidate;
+    ++onsets;
+}
+
+double TempoTracker::pickBpm(const std::vector<double>& acf, double* normalisedPeak) const
+{
+    int best = -1;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        const double score = acf[(size_t) lag] * prior[(size_t) lag];
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = lag;
+        }
+    }
+    if (best < 0)
+        return kNoEstimate;
+
+    // Parabolic refinement around the peak for sub-hop lag resolution.
+    double lag = (double) best;
+    if (best > minLag && best < maxLag)
+    {
+        const double a = acf[(size_t) best - 1] * prior[(size_t) best - 1];
+        const double c = acf[(size_t) best + 1] * prior[(size_t) best + 1];
+        const double denom = a - 2.0 * bestScore + c;
+        if (denom < 0.0)
+            lag += 0.5 * (a - c) / denom;
+    }
+
+    if (normalisedPeak != nullptr)
+        *normalisedPeak = acf[(size_t) best];
+    return 60.0 / (lag * hopSec);
+}
+
+double TempoTracker::currentBpm() const
+{
+    if ((double) validHops * hopSec < kMinSecondsForEstimate || localEnergy <= 0.0)
+        return kNoEstimate;
+    return pickBpm(localAcf, nullptr);
+}
+
+double TempoTracker::globalBpm() const
+{
+    if ((double) validHops * hopSec < kMinSecondsForEstimate || globalEnergy <= 0.0)
+        return kNoEstimate;
+    return pickBpm(globalAcf, nullptr);
+}
+
+double TempoTracker::globalConfidence() const
+{
+    if (globalEnergy <= 0.0)
+        return kNoEstimate;
+    double peak = 0.0;
+    if (std::isnan(pickBpm(globalAcf, &peak)))
+        return kNoEstimate;
+    return std::clamp(peak / globalEnergy, 0.0, 1.0);
+}
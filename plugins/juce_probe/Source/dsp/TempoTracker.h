@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SpectralAnalyzer.h"
+
+// Incremental onset detection and tempo estimation on the spectral flux stream
+// (one value per SpectralAnalyzer hop), run on the collector thread.
+//
+// Onsets: the flux is detrended against a ~0.5 s running mean and half-wave
+// rectified; local maxima above a multiple of the mean are counted.
+// Tempo: the onset envelope is autocorrelated over lags covering 40..220 BPM,
+// both into a leaky accumulator (~8 s memory, the tempo curve) and a session
+// accumulator (global BPM). Lags are weighted by a log-normal prior around
+// 120 BPM to settle octave ambiguity. State is bounded by the lag range and
+// sized in prepare(); nothing allocates afterwards, and results are available
+// at any time without a second pass.
+class TempoTracker : public SpectralAnalyzer::HopListener
+{
+public:
+    void prepare(double hopSeconds);
+    void reset();
+
+    void spectralHopAnalysed(float flux) override;
+    void spectralHopSkipped() override;
+
+    // NaN until enough envelope has been seen (a few beats at the slowest tempo).
+    double currentBpm() const;
+    double globalBpm() const;
+    double globalConfidence() const; // normalised autocorrelation at the chosen lag, 0..1
+
+    int64_t onsetCount() const { return onsets; }
+
+private:
+    void pushEnvelope(float value, bool valid);
+    void detectOnset();
+    double pickBpm(const std::vector<double>& acf, double* normalisedPeak) const;
+    float historyAt(int64_t index) const;
+
+    double hopSec{512.0 / 48000.0};
+    int minLag{1};
+    int maxLag{2};
+    int peakHalfWidth{3};
+    double meanCoeff{0.0};
+    double localDecay{0.0};
+
+    std::vector<float> history; // ring, NaN marks skipped hops
+    int64_t historyMask{0};
+    int64_t numHops{0};
+    int64_t validHops{0};
+
+    std::vector<double> localAcf, globalAcf, prior;
+    double localEnergy{0.0};
+    double globalEnergy{0.0};
+
+    double fluxMean{0.0};
+    double envelopeMean{0.0};
+    int64_t lastOnsetHop{-1};
+    int64_t onsets{0};
+};
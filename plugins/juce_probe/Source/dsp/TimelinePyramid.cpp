@@ -0,0 +1,226 @@
+#include "TimelinePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr TimelinePyramid::Bin kEmptyBin{ kNaN, kNaN, kNaN, kNaN };
+// A frame that ends this close past a bin edge is float noise, not audio in the next bin.
+constexpr double kEdgeToleranceSec = 1.0e-9;
+} // namespace
+
+double TimelinePyramid::binSeconds(int level)
+{
+    auto seconds = kFinestBinSec;
+    for (int i = 0; i < level; ++i)
+        seconds *= kFanOut;
+    return seconds;
+}
+
+int TimelinePyramid::levelForBinSeconds(double seconds)
+{
+    for (int level = 0; level < kNumLevels; ++level)
+        if (std::abs(seconds - binSeconds(level)) <= 0.01 * binSeconds(level))
+            return level;
+    return -1;
+}
+
+void TimelinePyramid::prepare(double maxSessionSec, double ringWindowSec)
+{
+    const auto windowSec = ringWindowSec > 0.0 ? ringWindowSec : maxSessionSec;
+    for (int level = 0; level < kNumLevels; ++level)
+    {
+        const auto wanted = std::ceil(std::max(0.0, windowSec) / binSeconds(level)) + 1.0;
+        auto& l = levels[(size_t) level];
+        l.capacity = (int64_t) std::min(wanted, (double) kMaxBinsPerLevel);
+        // Keep no more than the new ring needs; the slots are rewritten from clear().
+        if ((int64_t) l.slots.capacity() > l.capacity)
+            std::vector<Slot>().swap(l.slots);
+    }
+    clear();
+}
+
+void TimelinePyramid::clear()
+{
+    for (auto& level : levels)
+    {
+        level.slots.clear(); // bin indices restart at 0, so old tags must not survive
+        level.open = {};
+        level.openIndex = 0;
+        level.end = 0;
+    }
+}
+
+void TimelinePyramid::release()
+{
+    for (auto& level : levels)
+    {
+        std::vector<Slot>().swap(level.slots);
+        level.capacity = 0;
+    }
+    clear();
+}
+
+void TimelinePyramid::ingest(double startSec, double durationSec, double meanSquare, float peakLinear)
+{
+    auto& base = levels[0];
+    if (base.capacity == 0 || ! (durationSec > 0.0))
+        return;
+
+    const auto rms = (float) std::sqrt(std::max(0.0, meanSquare));
+    const auto endSec = startSec + durationSec;
+    // Frames arrive in order; one that starts early (timestamp jitter) pools into the open bin.
+    auto index = std::max(base.openIndex, (int64_t) std::floor((startSec + kEdgeToleranceSec) / kFinestBinSec));
+    auto fromSec = std::max(startSec, (double) index * kFinestBinSec);
+    for (;;)
+    {
+        advance(0, index);
+        const auto binEndSec = (double) (index + 1) * kFinestBinSec;
+        const auto toSec = std::min(endSec, binEndSec);
+        base.open.add(meanSquare, std::max(toSec - fromSec, kEdgeToleranceSec), rms, peakLinear);
+        if (endSec <= binEndSec + kEdgeToleranceSec)
+            break;
+        fromSec = binEndSec;
+        ++index;
+    }
+}
+
+int64_t TimelinePyramid::firstBin(int level) const
+{
+    const auto& l = levels[(size_t) level];
+    return std::max<int64_t>(0, l.end - l.capacity);
+}
+
+const TimelinePyramid::Bin& TimelinePyramid::bin(int level, int64_t index) const
+{
+    const auto& l = levels[(size_t) level];
+    if (index < firstBin(level) || index >= l.end)
+        return kEmptyBin;
+    const auto slot = (size_t) (index % l.capacity);
+    if (slot >= l.slots.size() || l.slots[slot].index != index)
+        return kEmptyBin;
+    return l.slots[slot].bin;
+}
+
+void TimelinePyramid::render(double startSec, double endSec, Bin* columns, int numColumns) const
+{
+    if (columns == nullptr || numColumns <= 0)
+        return;
+
+    std::fill(columns, columns + numColumns, kEmptyBin);
+    if (levels[0].capacity == 0 || ! (endSec > startSec))
+        return;
+
+    const auto columnSec = (endSec - startSec) / numColumns;
+    const auto retains = [this, startSec](int level)
+    { return (int64_t) std::floor(startSec / binSeconds(level)) >= firstBin(level); };
+
+    int level = 0;
+    while (level + 1 < kNumLevels && (binSeconds(level + 1) <= columnSec || ! retains(level)))
+        ++level;
+
+    const auto binSec = binSeconds(level);
+    const auto first = firstBin(level);
+    const auto end = endBin(level);
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto from = startSec + column * columnSec;
+        const auto lo = std::max(first, (int64_t) std::floor(from / binSec));
+        const auto hi = std::min(end, std::max(lo + 1, (int64_t) std::ceil((from + columnSec) / binSec)));
+
+        // Bins of one level are equally wide, so an unweighted mean pools their energy.
+        double energy = 0.0;
+        int filled = 0;
+        auto& out = columns[column];
+        for (auto i = lo; i < hi; ++i)
+        {
+            const auto& b = bin(level, i);
+            if (b.isEmpty())
+                continue;
+            out = filled == 0 ? b : Bin{ 0.0f, std::min(out.rmsMin, b.rmsMin), std::max(out.rmsMax, b.rmsMax),
+                                         std::max(out.peak, b.peak) };
+            energy += b.meanSquare;
+            ++filled;
+        }
+        if (filled > 0)
+            out.meanSquare = (float) (energy / filled);
+    }
+}
+
+void TimelinePyramid::advance(int level, int64_t index)
+{
+    auto& l = levels[(size_t) level];
+    if (index <= l.openIndex)
+        return;
+
+    closeOpenBin(level);
+    // Bins up to `index` saw no audio (capture off): jump over them. They are
+    // never stored, so they read as empty.
+    if (l.openIndex < index)
+        l.openIndex = l.end = index;
+}
+
+void TimelinePyramid::closeOpenBin(int level)
+{
+    auto& l = levels[(size_t) level];
+    if (l.open.seconds > 0.0)
+    {
+        store(l, l.openIndex, l.open.toBin());
+        if (level + 1 < kNumLevels)
+        {
+            advance(level + 1, l.openIndex / kFanOut);
+            levels[(size_t) level + 1].open.merge(l.open);
+        }
+    }
+    l.end = l.openIndex + 1;
+    l.open = {};
+    ++l.openIndex;
+}
+
+void TimelinePyramid::store(Level& level, int64_t index, const Bin& value)
+{
+    const auto slot = (size_t) (index % level.capacity);
+    if (slot >= level.slots.size())
+    {
+        // Grow geometrically up to the ring size; new slots hold no bin yet.
+        const auto grown = std::max<size_t>({ slot + 1, 2 * level.slots.size(), 1024 });
+        level.slots.resize(std::min(grown, (size_t) level.capacity), Slot{ kEmptyBin, -1 });
+    }
+    level.slots[slot] = { value, index };
+}
+
+void TimelinePyramid::Accumulator::add(double meanSquare, double durationSec, float rms, float peakLinear)
+{
+    Accumulator frame;
+    frame.energy = meanSquare * durationSec;
+    frame.seconds = durationSec;
+    frame.rmsMin = frame.rmsMax = rms;
+    frame.peak = peakLinear;
+    merge(frame);
+}
+
+void TimelinePyramid::Accumulator::merge(const Accumulator& other)
+{
+    if (other.seconds <= 0.0)
+        return;
+    if (seconds <= 0.0)
+    {
+        *this = other;
+        return;
+    }
+    energy += other.energy;
+    seconds += other.seconds;
+    rmsMin = std::min(rmsMin, other.rmsMin);
+    rmsMax = std::max(rmsMax, other.rmsMax);
+    peak = std::max(peak, other.peak);
+}
+
+TimelinePyramid::Bin TimelinePyramid::Accumulator::toBin() const
+{
+    if (seconds <= 0.0)
+        return kEmptyBin;
+    return { (float) (energy / seconds), rmsMin, rmsMax, peak };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Min/max/mean level envelope of the session at 10 ms, 100 ms, 1 s and 10 s
+// resolution, for waveform-style overviews and zoomable sidecar views. Frames
+// are pooled into the finest level by time overlap and every completed bin is
+// folded into its parent, so ingest costs O(1) per frame (amortised) and every
+// level pools all of its audio, whatever the host block size. Each level is a
+// ring that keeps its newest bins. prepare() only fixes the ring sizes; a ring
+// grows as bins are written (on the ingesting thread) up to its size. Bins with
+// no audio are never written: a slot tagged with another bin's index reads as
+// empty, so a capture gap of any length costs O(1) per level.
+class TimelinePyramid
+{
+public:
+    static constexpr int kNumLevels = 4;
+    static constexpr int kFanOut = 10;                  // bins per parent bin
+    static constexpr double kFinestBinSec = 0.01;
+    static constexpr size_t kMaxBinsPerLevel = 1 << 16; // 10 ms: ~11 min, 100 ms: ~1.8 h retained
+
+    // Linear amplitudes. All NaN when the bin saw no audio (capture off).
+    struct Bin
+    {
+        float meanSquare; // energy mean, i.e. RMS^2 over the bin
+        float rmsMin;     // quietest and loudest frame RMS in the bin
+        float rmsMax;
+        float peak;
+
+        bool isEmpty() const { return ! (meanSquare >= 0.0f); }
+    };
+
+    static double binSeconds(int level);
+    // The level whose bins are `seconds` wide (within 1%), or -1.
+    static int levelForBinSeconds(double seconds);
+
+    // Message thread. Sizes each level's ring for maxSessionSec (or ringWindowSec
+    // when > 0), capped at kMaxBinsPerLevel. Allocates nothing.
+    void prepare(double maxSessionSec, double ringWindowSec);
+    void clear();
+    void release();
+
+    // Pools one frame covering [startSec, startSec + durationSec). Allocates only
+    // when a ring grows (amortised O(1), never once it is full).
+    void ingest(double startSec, double durationSec, double meanSquare, float peakLinear);
+
+    // Completed bins of `level` are [firstBin, endBin); bin i covers [i, i + 1) * binSeconds(level).
+    int64_t firstBin(int level) const;
+    int64_t endBin(int level) const { return levels[(size_t) level].end; }
+    const Bin& bin(int level, int64_t index) const;
+    double endSec() const { return (double) endBin(0) * kFinestBinSec; }
+
+    // Pools [startSec, endSec) into `numColumns` bins, from the coarsest level
+    // that is no wider than a column and still retains startSec.
+    void render(double startSec, double endSec, Bin* columns, int numColumns) const;
+
+private:
+    struct Accumulator
+    {
+        double energy{0.0};  // meanSquare x seconds
+        double seconds{0.0};
+        float rmsMin{0.0f};
+        float rmsMax{0.0f};
+        float peak{0.0f};
+
+        void add(double meanSquare, double durationSec, float rms, float peakLinear);
+        void merge(const Accumulator& other);
+        Bin toBin() const;
+    };
+
+    struct Slot
+    {
+        Bin bin;
+        int64_t index; // bin index stored here; any other index reads as empty
+    };
+
+    struct Level
+    {
+        std::vector<Slot> slots; // ring slot for bin i is i % capacity; grows to capacity
+        int64_t capacity{0};
+        Accumulator open;
+        int64_t openIndex{0};
+        int64_t end{0};
+    };
+
+    void advance(int level, int64_t index);
+    void closeOpenBin(int level);
+    void store(Level& level, int64_t index, const Bin& value);
+
+    std::array<Level, kNumLevels> levels;
+};
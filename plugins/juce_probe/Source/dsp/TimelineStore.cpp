@@ -0,0 +1,134 @@
+#include "TimelineStore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <new>
+
+void TimelineStore::prepare(const Config& config, double pointSpacingSec, double sampleRate, int maxBlockSize,
+                            bool withSpectral)
+{
+    ringMode = config.ringWindowSec > 0.0;
+    const double windowSec = ringMode ? std::min(config.ringWindowSec, config.maxSessionSec)
+                                      : config.maxSessionSec;
+    const double blockSec = sampleRate > 0.0 ? (double) std::max(1, maxBlockSize) / sampleRate : 0.0;
+    const double effectiveSpacing = std::max(pointSpacingSec, blockSec);
+    const auto wanted = (size_t) std::ceil(std::max(0.0, windowSec) / std::max(1.0e-3, effectiveSpacing)) + 1;
+
+    // Chunks kept from a previous prepare() are reused; only the table and the
+    // first chunk are allocated up front.
+    chunks.resize((wanted + kChunkPoints - 1) / kChunkPoints);
+    spectralColumn = withSpectral;
+    if (! spectralColumn)
+        for (auto& chunk : chunks)
+            chunk.spectral.reset();
+
+    capacityPoints = wanted;
+    if (! ensureChunk(0))
+        capacityPoints = 0;
+    clear();
+}
+
+void TimelineStore::clear()
+{
+    head = 0;
+    count = 0;
+    pushed = 0;
+    dropped = 0;
+    ++resetGeneration;
+}
+
+void TimelineStore::release()
+{
+    chunks.clear();
+    chunks.shrink_to_fit();
+    capacityPoints = 0;
+    spectralColumn = false;
+    clear();
+}
+
+bool TimelineStore::ensureChunk(size_t chunkIndex)
+{
+    auto& chunk = chunks[chunkIndex];
+    if (chunk.core == nullptr)
+        chunk.core.reset(new (std::nothrow) CoreSlot[kChunkPoints]);
+    if (spectralColumn && chunk.spectral == nullptr)
+        chunk.spectral.reset(new (std::nothrow) SpectralSlot[kChunkPoints]);
+    return chunk.core != nullptr && (! spectralColumn || chunk.spectral != nullptr);
+}
+
+bool TimelineStore::push(const TimelinePoint& point)
+{
+    ++pushed;
+    if (capacityPoints == 0)
+    {
+        ++dropped;
+        return false;
+    }
+
+    if (count < capacityPoints)
+    {
+        const auto physical = (head + count) % capacityPoints;
+        if (! ensureChunk(physical / kChunkPoints))
+        {
+            ++dropped;
+            return false;
+        }
+        write(physical, point);
+        ++count;
+        return true;
+    }
+
+    if (! ringMode)
+    {
+        ++dropped;
+        return false;
+    }
+
+    // Ring full (every chunk allocated): overwrite the oldest point.
+    write(head, point);
+    head = (head + 1) % capacityPoints;
+    return true;
+}
+
+void TimelineStore::write(size_t physicalIndex, const TimelinePoint& point)
+{
+    const auto& chunk = chunks[physicalIndex / kChunkPoints];
+    const auto offset = physicalIndex % kChunkPoints;
+    chunk.core[offset] = { point.timeSec, point.rmsDb, point.peakDb, point.momentaryLufs, point.shortTermLufs };
+    if (spectralColumn)
+    {
+        auto& slot = chunk.spectral[offset];
+        slot.centroidHz = point.spectral.centroidHz;
+        slot.rolloffHz = point.spectral.rolloffHz;
+        slot.flux = point.spectral.flux;
+        std::copy(point.spectral.octaveBandDb.begin(), point.spectral.octaveBandDb.end(), slot.octaveBandDb);
+        slot.tempoBpm = point.tempoBpm;
+    }
+}
+
+TimelinePoint TimelineStore::operator[](size_t index) const
+{
+    assert(index < count);
+    const auto physical = (head + index) % capacityPoints;
+    const auto& chunk = chunks[physical / kChunkPoints];
+    const auto offset = physical % kChunkPoints;
+
+    TimelinePoint point;
+    const auto& core = chunk.core[offset];
+    point.timeSec = core.timeSec;
+    point.rmsDb = core.rmsDb;
+    point.peakDb = core.peakDb;
+    point.momentaryLufs = core.momentaryLufs;
+    point.shortTermLufs = core.shortTermLufs;
+    if (spectralColumn)
+    {
+        const auto& slot = chunk.spectral[offset];
+        point.spectral.centroidHz = slot.centroidHz;
+        point.spectral.rolloffHz = slot.rolloffHz;
+        point.spectral.flux = slot.flux;
+        std::copy(slot.octaveBandDb, slot.octaveBandDb + kNumOctaveBands, point.spectral.octaveBandDb.begin());
+        point.tempoBpm = slot.tempoBpm;
+    }
+    return point;
+}
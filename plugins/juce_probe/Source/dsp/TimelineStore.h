@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "FeatureTypes.h"
+
+// Chunked storage for the sidecar timeline, bounded by a ceiling fixed in
+// prepare(). Linear mode keeps the first maxSessionSec of a session and counts
+// the rest as dropped; ring mode keeps only the most recent ringWindowSec.
+// prepare() allocates the chunk table and the first chunk (~17 min); push()
+// allocates later chunks as the session reaches them, on the writer thread
+// (never the audio thread), so memory follows the session length rather than
+// the ceiling. The spectral/tempo fields live in a separate column that only
+// exists when prepared with the spectral stage on.
+class TimelineStore
+{
+public:
+    struct Config
+    {
+        double maxSessionSec{6.0 * 60.0 * 60.0};
+        double ringWindowSec{0.0}; // > 0 enables "last N seconds" ring mode
+    };
+
+    // Sizes the ceiling for the worst case: one point per spacing interval, or
+    // one per host block when blocks are longer than the spacing.
+    void prepare(const Config& config, double pointSpacingSec, double sampleRate, int maxBlockSize,
+                 bool withSpectral = false);
+    void clear();
+    // Frees the chunks (releaseResources); push() drops everything until prepare().
+    void release();
+
+    // Returns false if the point was dropped (linear mode at the ceiling, or a
+    // chunk could not be allocated).
+    bool push(const TimelinePoint& point);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return capacityPoints; }
+    bool isRing() const { return ringMode; }
+    int64_t totalPushed() const { return pushed; } // monotonic, includes overwritten/dropped
+    int64_t droppedPoints() const { return dropped; }
+    int64_t overwrittenPoints() const { return ringMode ? pushed - (int64_t) count : 0; }
+    // Bumped by every clear() (so by prepare() and release() too): incremental
+    // readers compare it to spot a restarted session, however long it has grown.
+    uint64_t generation() const { return resetGeneration; }
+
+    // Absolute (since clear()) index of operator[](0); lets incremental readers
+    // resume where they stopped even after ring overwrites.
+    int64_t firstRetainedIndex() const { return overwrittenPoints(); }
+
+    // Oldest-first access. Without the spectral column the spectral fields and
+    // tempo read as NaN, as the stage would have left them.
+    TimelinePoint operator[](size_t index) const;
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            fn((*this)[i]);
+    }
+
+private:
+    static constexpr size_t kChunkPoints = 4096;
+
+    // Plain data without initialisers: a new chunk is not written until used.
+    struct CoreSlot
+    {
+        double timeSec;
+        float rmsDb;
+        float peakDb;
+        float momentaryLufs;
+        float shortTermLufs;
+    };
+
+    struct SpectralSlot
+    {
+        float centroidHz;
+        float rolloffHz;
+        float flux;
+        float octaveBandDb[kNumOctaveBands];
+        float tempoBpm;
+    };
+
+    struct Chunk
+    {
+        std::unique_ptr<CoreSlot[]> core;
+        std::unique_ptr<SpectralSlot[]> spectral; // only withSpectral
+    };
+
+    bool ensureChunk(size_t chunkIndex);
+    void write(size_t physicalIndex, const TimelinePoint& point);
+
+    std::vector<Chunk> chunks; // capacityPoints / kChunkPoints entries, filled on demand
+    size_t capacityPoints{0};
+    size_t head{0}; // physical index of the oldest point
+    size_t count{0};
+    bool ringMode{false};
+    bool spectralColumn{false};
+    int64_t pushed{0};
+    int64_t dropped{0};
+    uint64_t resetGeneration{0};
+};
@@ -0,0 +1,532 @@
+// _ma_probe_native: CPython extension that runs the probe's DSP core
+// (FrameAnalyzer, FeatureCollector with loudness and the spectral/tempo stages)
+// over in-memory audio, so Python tools report the same numbers as the plugin
+// and ma_probe_batch instead of reimplementing them.
+//
+//   analyse(samples, sample_rate, *, block_size=512, spectral=False, channels_last=False) -> dict
+//   analyse_batch(buffers, sample_rate, *, threads=0, block_size=512, spectral=False,
+//                 channels_last=False) -> list[dict]
+//
+// `samples` is any float32 buffer (NumPy array, memoryview, array.array): 1-D
+// mono, or 2-D (channels, frames), or (frames, channels) with channels_last.
+// It is read in place through the buffer protocol; only strided channels are
+// gathered, one block at a time. Analysis runs with the GIL released, and
+// analyse_batch spreads its buffers over worker threads, one per core.
+//
+// Each result holds "global" (the sidecar's features.global keys),
+// "timeline" (read-only float32 columns, time_sec float64, as memoryviews for
+// np.asarray) and "timeline_dropped_points".
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../dsp/FeatureCollector.h"
+#include "../dsp/FrameAnalyzer.h"
+#include "../dsp/SidecarSchema.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+constexpr int kDefaultBlockSize = 512;
+constexpr int kMaxChannels = 64;
+
+struct AnalysisOptions
+{
+    int blockSize{kDefaultBlockSize};
+    bool spectral{false};
+    bool channelsLast{false};
+};
+
+// A validated view of one caller buffer; `view` is held until release().
+struct AudioInput
+{
+    Py_buffer view{};
+    bool acquired{false};
+    int numChannels{0};
+    Py_ssize_t numFrames{0};
+    Py_ssize_t channelStride{0}; // bytes
+    Py_ssize_t frameStride{0};   // bytes
+    double sampleRate{0.0};
+
+    void release()
+    {
+        if (acquired)
+            PyBuffer_Release(&view);
+        acquired = false;
+    }
+};
+
+struct AnalysisResult
+{
+    bool ok{false};
+    const char* error{nullptr};
+    GlobalFeatures global;
+    std::vector<TimelinePoint> timeline;
+    int64_t timelineDroppedPoints{0};
+};
+
+bool isNativeFloat32(const char* format)
+{
+    if (format == nullptr)
+        return true; // PyBUF_FORMAT not honoured: unsigned bytes, rejected by itemsize
+    if (*format == '@' || *format == '=' || (*format == '<' && ! juce::ByteOrder::isBigEndian()))
+        ++format;
+    return std::strcmp(format, "f") == 0;
+}
+
+// Sets a Python exception and returns false if `object` is not usable audio.
+bool acquireInput(PyObject* object, double sampleRate, bool channelsLast, AudioInput& input)
+{
+    if (! (sampleRate > 0.0))
+    {
+        PyErr_SetString(PyExc_ValueError, "sample_rate must be positive");
+        return false;
+    }
+    if (PyObject_GetBuffer(object, &input.view, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+        return false;
+    input.acquired = true;
+
+    const auto& view = input.view;
+    if (view.itemsize != 4 || ! isNativeFloat32(view.format))
+    {
+        PyErr_SetString(PyExc_TypeError, "samples must be float32 (e.g. np.asarray(y, dtype=np.float32))");
+        input.release();
+        return false;
+    }
+    if (view.ndim == 1)
+    {
+        input.numChannels = 1;
+        input.numFrames = view.shape[0];
+        input.frameStride = view.strides[0];
+    }
+    else if (view.ndim == 2)
+    {
+        const int channelAxis = channelsLast ? 1 : 0;
+        input.numChannels = (int) std::min<Py_ssize_t>(view.shape[channelAxis], kMaxChannels + 1);
+        input.numFrames = view.shape[1 - channelAxis];
+        input.channelStride = view.strides[channelAxis];
+        input.frameStride = view.strides[1 - channelAxis];
+    }
+    else
+    {
+        PyErr_SetString(PyExc_ValueError, "samples must be 1-D (mono) or 2-D (channels, frames)");
+        input.release();
+        return false;
+    }
+    if (input.numChannels < 1 || input.numChannels > kMaxChannels)
+    {
+        PyErr_Format(PyExc_ValueError, "samples must have 1 to %d channels", kMaxChannels);
+        input.release();
+        return false;
+    }
+    input.sampleRate = sampleRate;
+    return true;
+}
+
+// GIL released. Mirrors ma_probe_batch's analyseFile on an in-memory buffer.
+AnalysisResult analyseInput(const AudioInput& input, const AnalysisOptions& options)
+{
+    AnalysisResult result;
+    if (input.numFrames <= 0)
+    {
+        result.error = "samples are empty";
+        return result;
+    }
+
+    const auto numChannels = input.numChannels;
+    const auto sampleRate = input.sampleRate;
+    const auto length = (int64_t) input.numFrames;
+
+    auto layout = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    if (layout.size() != numChannels)
+        layout = juce::AudioChannelSet::discreteChannels(numChannels);
+
+    FrameAnalyzer analyzer;
+    analyzer.prepare(sampleRate, layout);
+
+    TimelineStore::Config timelineConfig;
+    timelineConfig.maxSessionSec = (double) length / sampleRate + 1.0;
+
+    SpectralAnalyzer::Config spectralConfig;
+    spectralConfig.enabled = options.spectral;
+    spectralConfig.cpuBudgetFraction = 0.0;
+
+    FeatureCollector collector(FeatureCollector::Threading::inlineOnly);
+    collector.setTimelineConfig(timelineConfig);
+    collector.setSpectralConfig(spectralConfig);
+    collector.prepare(sampleRate, options.blockSize, numChannels);
+
+    // Contiguous channels are read in place; strided ones (interleaved arrays,
+    // transposed views) are gathered into `scratch` per block.
+    const auto* base = static_cast<const char*>(input.view.buf);
+    const bool contiguous = input.frameStride == (Py_ssize_t) sizeof(float);
+    std::vector<float> scratch(contiguous ? 0 : (size_t) numChannels * (size_t) options.blockSize);
+    std::vector<const float*> channels((size_t) numChannels);
+
+    for (int64_t pos = 0; pos < length;)
+    {
+        const auto n = (int) std::min<int64_t>(options.blockSize, length - pos);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* first = base + ch * input.channelStride + (Py_ssize_t) pos * input.frameStride;
+            if (contiguous)
+            {
+                channels[(size_t) ch] = reinterpret_cast<const float*>(first);
+                continue;
+            }
+            auto* dest = scratch.data() + (size_t) ch * (size_t) options.blockSize;
+            for (int i = 0; i < n; ++i)
+                std::memcpy(dest + i, first + i * input.frameStride, sizeof(float));
+            channels[(size_t) ch] = dest;
+        }
+
+        const auto frame = analyzer.analyse(channels.data(), numChannels, n, (double) pos / sampleRate);
+        collector.ingestSamples(channels.data(), numChannels, n);
+        collector.ingestFrames(&frame, 1);
+        pos += n;
+    }
+
+    result.global = collector.finishInline();
+    const auto& timeline = collector.getTimeline();
+    result.timeline.reserve(timeline.size());
+    timeline.forEach([&](const TimelinePoint& point) { result.timeline.push_back(point); });
+    result.timelineDroppedPoints = timeline.droppedPoints() + timeline.overwrittenPoints();
+    result.ok = true;
+    return result;
+}
+
+AnalysisResult analyseInputNoThrow(const AudioInput& input, const AnalysisOptions& options)
+{
+    try
+    {
+        return analyseInput(input, options);
+    }
+    catch (const std::bad_alloc&)
+    {
+        AnalysisResult result;
+        result.error = "out of memory";
+        return result;
+    }
+}
+
+// Result building (GIL held). Each helper returns a new reference or nullptr
+// with the Python error set.
+
+bool setItem(PyObject* dict, const char* key, PyObject* value)
+{
+    if (value == nullptr)
+        return false;
+    const int status = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return status == 0;
+}
+
+// A read-only memoryview over a fresh bytes object, cast to `format`/`shape`.
+template <typename T, typename ValueOf>
+PyObject* makeColumn(const std::vector<TimelinePoint>& points, const char* format, int width, ValueOf&& valueOf)
+{
+    const auto count = (Py_ssize_t) points.size() * width;
+    PyObject* bytes = PyBytes_FromStringAndSize(nullptr, count * (Py_ssize_t) sizeof(T));
+    if (bytes == nullptr)
+        return nullptr;
+    auto* dest = reinterpret_cast<T*>(PyBytes_AS_STRING(bytes));
+    for (const auto& point : points)
+        for (int i = 0; i < width; ++i)
+            *dest++ = (T) valueOf(point, i);
+
+    PyObject* raw = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (raw == nullptr)
+        return nullptr;
+    PyObject* view = width == 1 ? PyObject_CallMethod(raw, "cast", "s", format)
+                                : PyObject_CallMethod(raw, "cast", "s(ni)", format, (Py_ssize_t) points.size(), width);
+    Py_DECREF(raw);
+    return view;
+}
+
+PyObject* makeBandList(const std::array<float, kNumOctaveBands>& bands)
+{
+    PyObject* list = PyList_New(kNumOctaveBands);
+    if (list == nullptr)
+        return nullptr;
+    for (int i = 0; i < kNumOctaveBands; ++i)
+    {
+        PyObject* value = PyFloat_FromDouble(bands[(size_t) i]);
+        if (value == nullptr)
+        {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, value);
+    }
+    return list;
+}
+
+// Same keys as SidecarSchema::writeGlobal; the spectral and tempo keys only
+// when the stage ran.
+PyObject* makeGlobal(const GlobalFeatures& global)
+{
+    PyObject* dict = PyDict_New();
+    if (dict == nullptr)
+        return nullptr;
+
+    bool ok = setItem(dict, "duration_sec", PyFloat_FromDouble(global.durationSec))
+           && setItem(dict, "integrated_rms_db", PyFloat_FromDouble(global.integratedRmsDb))
+           && setItem(dict, "peak_db", PyFloat_FromDouble(global.peakDb))
+           && setItem(dict, "crest_factor_db", PyFloat_FromDouble(global.crestDb))
+           && setItem(dict, "integrated_lufs", PyFloat_FromDouble(global.integratedLufs))
+           && setItem(dict, "max_momentary_lufs", PyFloat_FromDouble(global.maxMomentaryLufs))
+           && setItem(dict, "max_short_term_lufs", PyFloat_FromDouble(global.maxShortTermLufs))
+           && setItem(dict, "true_peak_dbtp", PyFloat_FromDouble(global.truePeakDbtp));
+    if (ok && global.spectral.isValid())
+    {
+        ok = setItem(dict, "spectral_centroid_hz", PyFloat_FromDouble(global.spectral.centroidHz))
+          && setItem(dict, "spectral_rolloff_hz", PyFloat_FromDouble(global.spectral.rolloffHz))
+          && setItem(dict, "spectral_flux", PyFloat_FromDouble(global.spectral.flux))
+          && setItem(dict, "octave_band_db", makeBandList(global.spectral.octaveBandDb))
+          && setItem(dict, "bpm", PyFloat_FromDouble(global.bpm))
+          && setItem(dict, "bpm_confidence", PyFloat_FromDouble(global.bpmConfidence))
+          && setItem(dict, "onset_count", PyLong_FromLongLong(global.onsetCount))
+          && setItem(dict, "onset_rate_hz", PyFloat_FromDouble(global.onsetRateHz));
+    }
+    if (! ok)
+    {
+        Py_DECREF(dict);
+        return nullptr;
+    }
+    return dict;
+}
+
+// Column names follow the sidecar timeline; octave_band_db is (points, bands).
+PyObject* makeTimeline(const std::vector<TimelinePoint>& points, bool spectral)
+{
+    PyObject* dict = PyDict_New();
+    if (dict == nullptr)
+        return nullptr;
+
+    const auto scalar = [&](const char* key, auto member)
+    {
+        return setItem(dict, key, makeColumn<float>(points, "f", 1,
+                                                     [member](const TimelinePoint& p, int) { return p.*member; }));
+    };
+
+    bool ok = setItem(dict, "time_sec", makeColumn<double>(points, "d", 1,
+                                                           [](const TimelinePoint& p, int) { return p.timeSec; }))
+           && scalar("rms_db", &TimelinePoint::rmsDb)
+           && scalar("peak_db", &TimelinePoint::peakDb)
+           && scalar("momentary_lufs", &TimelinePoint::momentaryLufs)
+           && scalar("short_term_lufs", &TimelinePoint::shortTermLufs);
+    if (ok && spectral)
+    {
+        const auto band = [](const TimelinePoint& p, int i) { return p.spectral.octaveBandDb[(size_t) i]; };
+        ok = setItem(dict, "spectral_centroid_hz", makeColumn<float>(points, "f", 1,
+                         [](const TimelinePoint& p, int) { return p.spectral.centroidHz; }))
+          && setItem(dict, "spectral_rolloff_hz", makeColumn<float>(points, "f", 1,
+                         [](const TimelinePoint& p, int) { return p.spectral.rolloffHz; }))
+          && setItem(dict, "spectral_flux", makeColumn<float>(points, "f", 1,
+                         [](const TimelinePoint& p, int) { return p.spectral.flux; }))
+          && setItem(dict, "octave_band_db", makeColumn<float>(points, "f", kNumOctaveBands, band))
+          && scalar("tempo_bpm", &TimelinePoint::tempoBpm);
+    }
+    if (! ok)
+    {
+        Py_DECREF(dict);
+        return nullptr;
+    }
+    return dict;
+}
+
+PyObject* makeResult(const AnalysisResult& result, const AnalysisOptions& options)
+{
+    if (! result.ok)
+    {
+        PyErr_SetString(PyExc_ValueError, result.error != nullptr ? result.error : "analysis failed");
+        return nullptr;
+    }
+
+    PyObject* dict = PyDict_New();
+    if (dict == nullptr)
+        return nullptr;
+    const bool ok = setItem(dict, "version", PyUnicode_FromString(SidecarSchema::kVersion))
+                 && setItem(dict, "global", makeGlobal(result.global))
+                 && setItem(dict, "timeline", makeTimeline(result.timeline, options.spectral))
+                 && setItem(dict, "timeline_dropped_points", PyLong_FromLongLong(result.timelineDroppedPoints));
+    if (! ok)
+    {
+        Py_DECREF(dict);
+        return nullptr;
+    }
+    return dict;
+}
+
+bool parseBlockSize(int blockSize, AnalysisOptions& options)
+{
+    if (blockSize < 32 || blockSize > 65536)
+    {
+        PyErr_SetString(PyExc_ValueError, "block_size must be in [32, 65536]");
+        return false;
+    }
+    options.blockSize = blockSize;
+    return true;
+}
+
+PyObject* analyse(PyObject*, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = { "samples", "sample_rate", "block_size", "spectral", "channels_last", nullptr };
+    PyObject* samples = nullptr;
+    double sampleRate = 0.0;
+    int blockSize = kDefaultBlockSize;
+    int spectral = 0;
+    int channelsLast = 0;
+    if (! PyArg_ParseTupleAndKeywords(args, kwargs, "Od|$ipp", const_cast<char**>(keywords),
+                                      &samples, &sampleRate, &blockSize, &spectral, &channelsLast))
+        return nullptr;
+
+    AnalysisOptions options;
+    options.spectral = spectral != 0;
+    options.channelsLast = channelsLast != 0;
+    AudioInput input;
+    if (! parseBlockSize(blockSize, options) || ! acquireInput(samples, sampleRate, options.channelsLast, input))
+        return nullptr;
+
+    AnalysisResult result;
+    Py_BEGIN_ALLOW_THREADS
+    result = analyseInputNoThrow(input, options);
+    Py_END_ALLOW_THREADS
+    input.release();
+    return makeResult(result, options);
+}
+
+PyObject* analyseBatch(PyObject*, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = { "buffers", "sample_rate", "threads", "block_size",
+                                      "spectral", "channels_last", nullptr };
+    PyObject* buffers = nullptr;
+    PyObject* sampleRates = nullptr;
+    int numThreads = 0;
+    int blockSize = kDefaultBlockSize;
+    int spectral = 0;
+    int channelsLast = 0;
+    if (! PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$iipp", const_cast<char**>(keywords),
+                                      &buffers, &sampleRates, &numThreads, &blockSize, &spectral, &channelsLast))
+        return nullptr;
+
+    AnalysisOptions options;
+    options.spectral = spectral != 0;
+    options.channelsLast = channelsLast != 0;
+    if (! parseBlockSize(blockSize, options))
+        return nullptr;
+
+    PyObject* items = PySequence_Fast(buffers, "buffers must be a sequence");
+    if (items == nullptr)
+        return nullptr;
+    const auto count = PySequence_Fast_GET_SIZE(items);
+
+    // sample_rate: one number for every buffer, or a sequence of the same length.
+    PyObject* rates = nullptr;
+    double sharedRate = 0.0;
+    if (! PySequence_Check(sampleRates))
+    {
+        sharedRate = PyFloat_AsDouble(sampleRates);
+    }
+    else if ((rates = PySequence_Fast(sampleRates, "sample_rate must be a number or a sequence")) != nullptr
+             && PySequence_Fast_GET_SIZE(rates) != count)
+    {
+        PyErr_SetString(PyExc_ValueError, "sample_rate sequence must match buffers in length");
+    }
+
+    // Every buffer is acquired before the GIL is dropped and held until the
+    // workers are done, so callers cannot resize them mid-analysis.
+    std::vector<AudioInput> inputs((size_t) count);
+    bool ok = ! PyErr_Occurred();
+    for (Py_ssize_t i = 0; ok && i < count; ++i)
+    {
+        const auto rate = rates != nullptr ? PyFloat_AsDouble(PySequence_Fast_GET_ITEM(rates, i)) : sharedRate;
+        ok = ! PyErr_Occurred()
+          && acquireInput(PySequence_Fast_GET_ITEM(items, i), rate, options.channelsLast, inputs[(size_t) i]);
+    }
+    Py_XDECREF(rates);
+
+    std::vector<AnalysisResult> results((size_t) count);
+    if (ok && count > 0)
+    {
+        const auto hardware = (int) std::max(1u, std::thread::hardware_concurrency());
+        const auto workers = (int) std::min<Py_ssize_t>(numThreads > 0 ? numThreads : hardware, count);
+
+        Py_BEGIN_ALLOW_THREADS
+        std::atomic<Py_ssize_t> next{0};
+        const auto work = [&]
+        {
+            for (auto i = next++; i < count; i = next++)
+                results[(size_t) i] = analyseInputNoThrow(inputs[(size_t) i], options);
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < workers; ++t)
+            pool.emplace_back(work);
+        work();
+        for (auto& thread : pool)
+            thread.join();
+        Py_END_ALLOW_THREADS
+    }
+
+    for (auto& input : inputs)
+        input.release();
+    Py_DECREF(items);
+    if (! ok)
+        return nullptr;
+
+    PyObject* list = PyList_New(count);
+    if (list == nullptr)
+        return nullptr;
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+        PyObject* item = makeResult(results[(size_t) i], options);
+        if (item == nullptr)
+        {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+PyMethodDef moduleMethods[] = {
+    { "analyse", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(analyse)), METH_VARARGS | METH_KEYWORDS,
+      "analyse(samples, sample_rate, *, block_size=512, spectral=False, channels_last=False) -> dict\n\n"
+      "Runs the juce_probe feature core over a float32 buffer, read in place, with the GIL released." },
+    { "analyse_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(analyseBatch)),
+      METH_VARARGS | METH_KEYWORDS,
+      "analyse_batch(buffers, sample_rate, *, threads=0, block_size=512, spectral=False, channels_last=False)"
+      " -> list[dict]\n\n"
+      "analyse() over many buffers on `threads` worker threads (0: one per core), in input order." },
+    { nullptr, nullptr, 0, nullptr }
+};
+
+PyModuleDef moduleDef = {
+    PyModuleDef_HEAD_INIT,
+    "_ma_probe_native",
+    "juce_probe DSP core (frame kernel, loudness, spectral/tempo stages) for in-memory audio.",
+    -1,
+    moduleMethods,
+    nullptr, nullptr, nullptr, nullptr
+};
+} // namespace
+
+PyMODINIT_FUNC PyInit__ma_probe_native()
+{
+    PyObject* module = PyModule_Create(&moduleDef);
+    if (module == nullptr)
+        return nullptr;
+    if (PyModule_AddStringConstant(module, "SIDECAR_VERSION", SidecarSchema::kVersion) != 0
+        || PyModule_AddIntConstant(module, "DEFAULT_BLOCK_SIZE", kDefaultBlockSize) != 0)
+    {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
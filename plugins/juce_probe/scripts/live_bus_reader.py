@@ -0,0 +1,233 @@
+"""
+Reader for the JUCE probe's shared-memory live feature bus (MA_PROBE_LIVE_BUS=1).
+
+Maps the registry and instance segments read-only in spirit (no writes) and decodes
+them in place with `struct.unpack_from`; the binary layout is defined in
+plugins/common/include/ma/bus/LiveBusLayout.h. Standard library only.
+
+Usage:
+- CLI: `python plugins/juce_probe/scripts/live_bus_reader.py --list`
+  - Prints one JSON object per active probe instance (pid, segment, track/session ids).
+- CLI: `python plugins/juce_probe/scripts/live_bus_reader.py --follow [--track ID]`
+  - Streams new timeline points as NDJSON, plus an "aggregates" line per poll.
+- Import: `from live_bus_reader import list_instances, LiveBusSegment`
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import struct
+import sys
+import time
+from multiprocessing import resource_tracker, shared_memory
+from typing import Dict, Iterator, List, Optional
+
+REGISTRY_NAME = "ma_probe_registry"  # shm_open("/ma_probe_registry")
+SEGMENT_MAGIC = b"MAPRBUS1"
+REGISTRY_MAGIC = b"MAPRREG1"
+VERSION = 1
+
+SLOT_ACTIVE = 2
+ID_BYTES = 64
+NUM_OCTAVE_BANDS = 10
+
+# SegmentHeader offsets (static_asserts in LiveBusLayout.h).
+_HEADER_FIXED = struct.Struct("<8sIIIIII")  # magic, version, header/point bytes, capacity, pid, reserved
+_POINTS_WRITTEN = 32
+_HEARTBEAT_NS = 40
+_SEQ = 48
+_SEQLOCKED = struct.Struct("<IIQd11dq64s64s")  # seq, flags, generation, sample_rate, aggregates, ids
+_AGGREGATE_NAMES = (
+    "duration_sec",
+    "integrated_rms_db",
+    "peak_db",
+    "crest_db",
+    "integrated_lufs",
+    "max_momentary_lufs",
+    "max_short_term_lufs",
+    "true_peak_dbtp",
+    "bpm",
+    "bpm_confidence",
+    "onset_rate_hz",
+)
+_POINT = struct.Struct("<Qd8f10f")  # stamp, time, 8 scalar floats, octave bands
+_POINT_NAMES = (
+    "rms_db",
+    "peak_db",
+    "momentary_lufs",
+    "short_term_lufs",
+    "spectral_centroid_hz",
+    "spectral_rolloff_hz",
+    "spectral_flux",
+    "tempo_bpm",
+)
+
+# RegistryHeader / RegistrySlot.
+_REGISTRY_HEADER = struct.Struct("<8sIIII")
+_SLOT = struct.Struct("<IIQII32s64s64s")  # state, seq, heartbeat, pid, reserved, names
+
+
+def _open(name: str) -> shared_memory.SharedMemory:
+    shm = shared_memory.SharedMemory(name=name, create=False)
+    # Attaching must not hand the segment to this process's resource tracker,
+    # which would unlink the probe's segment when we exit.
+    try:
+        resource_tracker.unregister(shm._name, "shared_memory")  # type: ignore[attr-defined]
+    except Exception:
+        pass
+    return shm
+
+
+def _cstr(raw: bytes) -> str:
+    return raw.split(b"\0", 1)[0].decode("utf-8", errors="replace")
+
+
+def _json_number(value: float) -> Optional[float]:
+    return value if math.isfinite(value) else None
+
+
+def _read_seqlocked(buf: memoryview, seq_offset: int, layout: struct.Struct, offset: int, attempts: int = 64):
+    for _ in range(attempts):
+        before = struct.unpack_from("<I", buf, seq_offset)[0]
+        if before & 1:
+            continue
+        fields = layout.unpack_from(buf, offset)
+        if struct.unpack_from("<I", buf, seq_offset)[0] == before:
+            return fields
+    return None
+
+
+def list_instances() -> List[Dict[str, object]]:
+    """Active probe instances from the registry (empty when no probe has published)."""
+    try:
+        shm = _open(REGISTRY_NAME)
+    except FileNotFoundError:
+        return []
+    try:
+        buf = shm.buf
+        magic, version, header_bytes, slot_bytes, num_slots = _REGISTRY_HEADER.unpack_from(buf, 0)
+        if magic != REGISTRY_MAGIC or version != VERSION:
+            return []
+        instances = []
+        for i in range(num_slots):
+            offset = header_bytes + i * slot_bytes
+            fields = _read_seqlocked(buf, offset + 4, _SLOT, offset)
+            if fields is None or fields[0] != SLOT_ACTIVE:
+                continue
+            _, _, heartbeat_ns, pid, _, segment, track, session = fields
+            instances.append(
+                {
+                    "slot": i,
+                    "pid": pid,
+                    "segment": _cstr(segment),
+                    "track_id": _cstr(track),
+                    "session_id": _cstr(session),
+                    "heartbeat_age_sec": max(0.0, time.time() - heartbeat_ns / 1e9),
+                }
+            )
+        del buf
+        return instances
+    finally:
+        shm.close()
+
+
+class LiveBusSegment:
+    """One probe instance's segment; read aggregates and new timeline points in place."""
+
+    def __init__(self, segment_name: str):
+        self._shm = _open(segment_name.lstrip("/"))
+        self._buf = self._shm.buf
+        magic, version, self.header_bytes, self.point_bytes, self.capacity, self.pid, _ = _HEADER_FIXED.unpack_from(
+            self._buf, 0
+        )
+        if magic != SEGMENT_MAGIC or version != VERSION:
+            self.close()
+            raise ValueError(f"{segment_name}: not a v{VERSION} probe live bus segment")
+        self.next_index = 0
+
+    def close(self) -> None:
+        self._buf = None  # release the exported view before closing the mapping
+        self._shm.close()
+
+    def points_written(self) -> int:
+        return struct.unpack_from("<Q", self._buf, _POINTS_WRITTEN)[0]
+
+    def heartbeat_age_sec(self) -> float:
+        return max(0.0, time.time() - struct.unpack_from("<Q", self._buf, _HEARTBEAT_NS)[0] / 1e9)
+
+    def aggregates(self) -> Optional[Dict[str, object]]:
+        fields = _read_seqlocked(self._buf, _SEQ, _SEQLOCKED, _SEQ)
+        if fields is None:
+            return None
+        _, flags, generation, sample_rate = fields[:4]
+        values = fields[4:15]
+        onset_count, track, session = fields[15:]
+        out: Dict[str, object] = {
+            "track_id": _cstr(track),
+            "session_id": _cstr(session),
+            "generation": generation,
+            "sample_rate": sample_rate,
+            "spectral": bool(flags & 1),
+            "onset_count": onset_count,
+        }
+        out.update({name: _json_number(v) for name, v in zip(_AGGREGATE_NAMES, values)})
+        return out
+
+    def read_new_points(self) -> Iterator[Dict[str, object]]:
+        """Points published since the previous call, oldest first. Points the writer
+        overwrote before we got to them are skipped (the ring keeps the newest)."""
+        written = self.points_written()
+        if written < self.next_index:
+            self.next_index = 0  # writer restarted the segment
+        start = max(self.next_index, written - self.capacity)
+        for index in range(start, written):
+            offset = self.header_bytes + (index % self.capacity) * self.point_bytes
+            fields = _POINT.unpack_from(self._buf, offset)
+            if fields[0] != index + 1 or struct.unpack_from("<Q", self._buf, offset)[0] != index + 1:
+                continue  # overwritten while we read it
+            point: Dict[str, object] = {"index": index, "time_sec": fields[1]}
+            point.update({name: _json_number(v) for name, v in zip(_POINT_NAMES, fields[2:10])})
+            point["octave_band_db"] = [_json_number(v) for v in fields[10 : 10 + NUM_OCTAVE_BANDS]]
+            yield point
+        self.next_index = written
+
+
+def _follow(track: Optional[str], interval: float) -> int:
+    matches = [i for i in list_instances() if track is None or i["track_id"] == track]
+    if not matches:
+        print("live_bus_reader: no matching probe instance", file=sys.stderr)
+        return 1
+    segment = LiveBusSegment(str(matches[0]["segment"]))
+    try:
+        while True:
+            for point in segment.read_new_points():
+                print(json.dumps({"type": "point", **point}))
+            aggregates = segment.aggregates()
+            if aggregates is not None:
+                print(json.dumps({"type": "aggregates", **aggregates}))
+            sys.stdout.flush()
+            time.sleep(interval)
+    except KeyboardInterrupt:
+        return 0
+    finally:
+        segment.close()
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--list", action="store_true", help="list active probe instances")
+    parser.add_argument("--follow", action="store_true", help="stream points/aggregates of one instance")
+    parser.add_argument("--track", help="track_id to follow (default: first active instance)")
+    parser.add_argument("--interval", type=float, default=0.25, help="poll interval in seconds (default 0.25)")
+    args = parser.parse_args(argv)
+
+    if args.follow:
+        return _follow(args.track, args.interval)
+    for instance in list_instances():
+        print(json.dumps(instance))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -1,70 +1,107 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <ma/dsp/BlockStats.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 struct ProbeStats {
   double rms = 0.0;
   double peak = 0.0;
   double crest = 0.0;
-  int64_t samples = 0;
+  int64_t samples = 0; // channel-samples
+  int channels = 0;
   double sampleRate = 44100.0;
 };
 
 /** Lightweight feature collector for RMS/peak/crest.
-    All fields are atomic so the audio thread never locks. */
+    Double-buffered: the audio thread accumulates into the active slot with plain
+    stores; the reader flips the active slot and drains the retired one, so a
+    snapshot never tears and no update is lost. No CAS loops on the audio thread. */
 class FeatureCollector {
 public:
-  void prepare(double sr) {
+  void prepare(double sr, int numChannels) {
     sampleRate.store(sr);
+    channels.store(numChannels);
     reset();
   }
 
+  // Not concurrent with push(): call while audio is stopped (prepareToPlay).
   void reset() {
-    sumSquares.store(0.0);
-    peak.store(0.0f);
-    totalSamples.store(0);
+    const std::lock_guard<std::mutex> lock(readerMutex);
+    for (auto &slot : slots)
+      slot = {};
   }
 
-  void push(const juce::AudioBuffer<float> &buffer) {
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    if (numSamples == 0 || numChannels == 0)
+  // Audio thread. `block` comes from ma::dsp::computeBlockStats, shared with
+  // the editor meter so the buffer is only scanned once.
+  void push(const ma::dsp::BlockStats &block) {
+    if (block.samples == 0)
       return;
 
-    float localPeak = 0.0f;
-    double localSum = 0.0;
-    for (int ch = 0; ch < numChannels; ++ch) {
-      auto *data = buffer.getReadPointer(ch);
-      for (int i = 0; i < numSamples; ++i) {
-        const float s = data[i];
-        localSum += static_cast<double>(s) * static_cast<double>(s);
-        localPeak = std::max(localPeak, std::abs(s));
-      }
-    }
-    peak.store(std::max(peak.load(), localPeak));
-    sumSquares.store(sumSquares.load() + localSum);
-    totalSamples.store(totalSamples.load() + static_cast<int64_t>(numSamples));
+    const int idx = enterActiveSlot();
+    auto &slot = slots[(size_t)idx];
+    slot.sumSquares += block.sumSquares;
+    slot.peak = std::max(slot.peak, block.peak);
+    slot.samples += block.samples; // channel-samples, matching sumSquares
+    slotBusy[(size_t)idx].store(false, std::memory_order_release);
   }
 
   ProbeStats snapshotAndReset() {
-    const double sum = sumSquares.exchange(0.0);
-    const double pk = peak.exchange(0.0f);
-    const int64_t n = totalSamples.exchange(0);
+    Slot retired;
+    {
+      const std::lock_guard<std::mutex> lock(readerMutex);
+      const int old = activeSlot.load(std::memory_order_relaxed);
+      activeSlot.store(1 - old, std::memory_order_seq_cst);
+      // The writer holds a slot for a few adds at most; wait it out.
+      while (slotBusy[(size_t)old].load(std::memory_order_seq_cst))
+        std::this_thread::yield();
+      retired = slots[(size_t)old];
+      slots[(size_t)old] = {};
+    }
+
     ProbeStats stats;
-    stats.samples = n;
+    stats.samples = retired.samples;
+    stats.channels = channels.load();
     stats.sampleRate = sampleRate.load();
-    if (n > 0) {
-      const double rmsLin = std::sqrt(sum / static_cast<double>(n));
+    if (retired.samples > 0) {
+      const double rmsLin =
+          std::sqrt(retired.sumSquares / static_cast<double>(retired.samples));
       stats.rms = rmsLin;
-      stats.peak = pk;
-      stats.crest = (rmsLin > 0.0) ? pk / rmsLin : 0.0;
+      stats.peak = retired.peak;
+      stats.crest = (rmsLin > 0.0) ? retired.peak / rmsLin : 0.0;
     }
     return stats;
   }
 
 private:
-  std::atomic<double> sumSquares{0.0};
-  std::atomic<float> peak{0.0f};
-  std::atomic<int64_t> totalSamples{0};
+  struct Slot {
+    double sumSquares = 0.0;
+    float peak = 0.0f;
+    int64_t samples = 0;
+  };
+
+  // Marks the active slot busy, re-checking in case the reader flipped in
+  // between (Dekker-style handshake; retries at most once per snapshot).
+  int enterActiveSlot() noexcept {
+    int idx = activeSlot.load(std::memory_order_acquire);
+    for (;;) {
+      slotBusy[(size_t)idx].store(true, std::memory_order_seq_cst);
+      const int now = activeSlot.load(std::memory_order_seq_cst);
+      if (now == idx)
+        return idx;
+      slotBusy[(size_t)idx].store(false, std::memory_order_release);
+      idx = now;
+    }
+  }
+
+  std::array<Slot, 2> slots{};
+  std::atomic<int> activeSlot{0};
+  std::array<std::atomic<bool>, 2> slotBusy{};
+  std::mutex readerMutex;
   std::atomic<double> sampleRate{44100.0};
+  std::atomic<int> channels{0};
 };
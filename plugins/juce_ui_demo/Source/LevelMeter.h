@@ -0,0 +1,89 @@
+#pragma once
+
+#include "gui/controls/MeterReading.h"
+#include <ma/dsp/BlockStats.h>
+#include <ma/dsp/KWeighting.h>
+
+#include <array>
+#include <cmath>
+
+/** Audio-thread side of the editor meter. Takes the block stats already
+    computed for the FeatureCollector (no second pass for peak/RMS), adds a
+    K-weighted pass for momentary LUFS, applies ballistics and publishes one
+    MeterReading per block through a wait-free triple buffer. */
+class LevelMeter {
+public:
+  void prepare(double sampleRate, int numChannels) {
+    sr = sampleRate > 0.0 ? sampleRate : 48000.0;
+    kWeighting.prepare(sr, numChannels);
+    subBlockSamples = (int)std::lround(sr * 0.1);
+    subBlocks.fill(0.0);
+    subBlockIndex = 0;
+    subBlockEnergy = 0.0;
+    subBlockFill = 0;
+    filledSubBlocks = 0;
+    peakHold = 0.0f;
+    rmsSquared = 0.0;
+  }
+
+  // Audio thread. `stats` is the block's computeBlockStats result.
+  void process(const float *const *channels, int numChannels, int numSamples,
+               const ma::dsp::BlockStats &stats) noexcept {
+    if (numSamples <= 0)
+      return;
+
+    // Peak: instant attack, ~20 dB/s fall. RMS: 300 ms exponential integration.
+    const auto blockSec = (double)numSamples / sr;
+    peakHold = std::max(stats.peak,
+                        peakHold * (float)std::pow(10.0, -20.0 * blockSec / 20.0));
+    const auto coeff = std::exp(-blockSec / 0.3);
+    rmsSquared = coeff * rmsSquared + (1.0 - coeff) * stats.meanSquare();
+
+    accumulateLoudness(kWeighting.process(channels, numChannels, numSamples),
+                       numSamples);
+
+    MeterReading reading;
+    reading.peak = peakHold;
+    reading.rms = (float)std::sqrt(rmsSquared);
+    reading.momentaryLufs = momentaryLufs;
+    channel.write(reading);
+  }
+
+  // Editor (single consumer).
+  MeterChannel &getChannel() noexcept { return channel; }
+
+private:
+  // 4 x 100 ms sub-blocks; closed at block granularity.
+  void accumulateLoudness(double energy, int numSamples) noexcept {
+    subBlockEnergy += energy;
+    subBlockFill += numSamples;
+    if (subBlockFill < subBlockSamples)
+      return;
+
+    subBlocks[(size_t)subBlockIndex] = subBlockEnergy / (double)subBlockFill;
+    subBlockIndex = (subBlockIndex + 1) % (int)subBlocks.size();
+    filledSubBlocks = std::min(filledSubBlocks + 1, (int)subBlocks.size());
+    subBlockEnergy = 0.0;
+    subBlockFill = 0;
+
+    if (filledSubBlocks == (int)subBlocks.size()) {
+      double sum = 0.0;
+      for (auto e : subBlocks)
+        sum += e;
+      momentaryLufs = (float)ma::dsp::energyToLufs(sum / (double)subBlocks.size());
+    }
+  }
+
+  double sr = 48000.0;
+  ma::dsp::KWeightingFilterBank kWeighting;
+  std::array<double, 4> subBlocks{};
+  int subBlockIndex = 0;
+  int subBlockSamples = 4800;
+  int filledSubBlocks = 0;
+  double subBlockEnergy = 0.0;
+  int subBlockFill = 0;
+  float momentaryLufs = -std::numeric_limits<float>::infinity();
+  float peakHold = 0.0f;
+  double rmsSquared = 0.0;
+  MeterChannel channel;
+};
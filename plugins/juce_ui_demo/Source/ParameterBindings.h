@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <atomic>
+#include <vector>
+
+/** An APVTS raw value resolved once (constructor), so the audio thread never
+    does a string lookup. load() is a relaxed atomic read. */
+class BoundParameter {
+public:
+  void bind(juce::AudioProcessorValueTreeState &vts, const juce::String &paramID) {
+    raw = vts.getRawParameterValue(paramID);
+    jassert(raw != nullptr);
+  }
+
+  float load() const noexcept {
+    return raw != nullptr ? raw->load(std::memory_order_relaxed) : 0.0f;
+  }
+
+private:
+  std::atomic<float> *raw = nullptr;
+};
+
+/** Per-sample linear gain ramp. The ramp is rendered once into a scratch
+    buffer and applied to every channel with FloatVectorOperations, so the
+    per-channel work stays a vectorised multiply; a settled gain is a plain
+    vectorised scale. */
+class GainRamp {
+public:
+  // Message thread (prepareToPlay): sizes the scratch buffer.
+  void prepare(double sampleRate, double rampSeconds, int maxBlockSize, float initialGain) {
+    smoothed.reset(sampleRate, rampSeconds);
+    smoothed.setCurrentAndTargetValue(initialGain);
+    scratch.assign((size_t)juce::jmax(1, maxBlockSize), 0.0f);
+  }
+
+  void setTarget(float gain) noexcept { smoothed.setTargetValue(gain); }
+
+  // Audio thread. Blocks larger than prepare()'s size are processed in chunks.
+  void apply(float *const *channels, int numChannels, int numSamples) noexcept {
+    for (int offset = 0; offset < numSamples;) {
+      const auto n = juce::jmin(numSamples - offset, (int)scratch.size());
+      if (smoothed.isSmoothing()) {
+        for (int i = 0; i < n; ++i)
+          scratch[(size_t)i] = smoothed.getNextValue();
+        for (int ch = 0; ch < numChannels; ++ch)
+          juce::FloatVectorOperations::multiply(channels[ch] + offset, scratch.data(), n);
+      } else {
+        const auto gain = smoothed.getCurrentValue();
+        for (int ch = 0; ch < numChannels; ++ch)
+          juce::FloatVectorOperations::multiply(channels[ch] + offset, gain, n);
+      }
+      offset += n;
+    }
+  }
+
+private:
+  juce::SmoothedValue<float> smoothed;
+  std::vector<float> scratch;
+};
@@ -18,7 +18,7 @@ MAStyleJuceDemoAudioProcessorEditor::MAStyleJuceDemoAudioProcessorEditor(
       envView(p.getValueTreeState(),
               *p.getValueTreeState().getParameter("attack"),
               *p.getValueTreeState().getParameter("release"), &um),
-      meter([&]() { return processorRef.getLastRms(); }),
+      meter(p.getMeterChannel()),
       seqView(p.getValueTreeState(),
               {
                   p.getValueTreeState().getParameter("step1"),
@@ -60,12 +60,17 @@ MAStyleJuceDemoAudioProcessorEditor::MAStyleJuceDemoAudioProcessorEditor(
   addAndMakeVisible(meter);
   addAndMakeVisible(seqView);
   addAndMakeVisible(badge);
+
+  animation.add(meter);
+  animation.add(toneDial);
+  animation.add(badge);
+
   setResizable(true, true);
   setSize(620, 360);
 }
 
 void MAStyleJuceDemoAudioProcessorEditor::paint(juce::Graphics &g) {
-  g.fillAll(juce::Colour::fromRGB(12, 16, 20));
+  g.fillAll(juce::Colour(ma::tokens::colour::background));
   auto area = getLocalBounds().toFloat().reduced(10.0f);
   g.setColour(guiBorder());
   g.drawRoundedRectangle(area, 12.0f, 1.2f);
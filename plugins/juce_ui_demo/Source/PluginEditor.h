@@ -4,6 +4,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 
+#include "gui/controls/AnimationScheduler.h"
 #include "gui/controls/Dial.h"
 #include "gui/controls/HaloKnob.h"
 #include "gui/controls/MiniEnvelope.h"
@@ -35,6 +36,8 @@ private:
   SimpleMeter meter;
   StepSequencerView seqView;
   AnimatedSvgBadge badge;
+  // Declared last: its vblank callback touches the controls above.
+  AnimationScheduler animation{*this};
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(
       MAStyleJuceDemoAudioProcessorEditor)
@@ -7,14 +7,11 @@ MAStyleJuceDemoAudioProcessor::MAStyleJuceDemoAudioProcessor()
               .withInput("Input", juce::AudioChannelSet::stereo(), true)
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       state(*this, nullptr, "MASTYLE_DEMO", createLayout()) {
-  rmsMeter.reset(48000.0, 0.05);
-  // Cache raw step params for quick access.
-  for (size_t i = 0; i < stepParams.size(); ++i)
-    stepParams[i] = state.getRawParameterValue("step" + juce::String((int)i + 1));
-}
-
-MAStyleJuceDemoAudioProcessor::~MAStyleJuceDemoAudioProcessor() {
-  pool.removeAllJobs(true, 1000);
+  params.drive.bind(state, "drive");
+  params.mix.bind(state, "mix");
+  params.tone.bind(state, "tone");
+  for (size_t i = 0; i < params.steps.size(); ++i)
+    params.steps[i].bind(state, "step" + juce::String((int)i + 1));
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -53,21 +50,117 @@ MAStyleJuceDemoAudioProcessor::createLayout() {
 
 void MAStyleJuceDemoAudioProcessor::prepareToPlay(double sampleRate,
                                                   int samplesPerBlock) {
-  juce::ignoreUnused(samplesPerBlock);
+  applyPendingState(); // ramps below start from the restored values
   juce::dsp::ProcessSpec spec{sampleRate, (juce::uint32)samplesPerBlock,
                               (juce::uint32)getTotalNumInputChannels()};
   dryWet.reset();
   dryWet.setMixingRule(juce::dsp::DryWetMixingRule::linear);
   dryWet.prepare(spec);
-  rmsMeter.reset(sampleRate, 0.05);
+  levelMeter.prepare(sampleRate, getTotalNumInputChannels());
+  // processBlock scans every buffer channel, i.e. max(inputs, outputs).
+  collector.prepare(sampleRate, juce::jmax(getTotalNumInputChannels(),
+                                           getTotalNumOutputChannels()));
 
   stepDeltaPerSample = (2.0 /* steps per second */ * (double)numSteps) / sampleRate;
   stepPhase = 0.0;
+
+  // 20 ms ramps: long enough to remove zipper noise from automation.
+  gain.prepare(sampleRate, 0.02, samplesPerBlock,
+               juce::Decibels::decibelsToGain(params.drive.load()));
+  stepEnvelope.prepare(sampleRate, samplesPerBlock);
+  toneHz.reset(sampleRate, 0.02);
+  toneHz.setCurrentAndTargetValue(params.tone.load());
+  lastToneHz = -1.0f;
+  toneFilter.prepare(getTotalNumOutputChannels());
+}
+
+void MAStyleJuceDemoAudioProcessor::releaseResources() {
+  finishOfflineRender(); // some hosts end a bounce by releasing
+  writer.stop();         // restarted by the next requestSidecar()
+}
+
+void MAStyleJuceDemoAudioProcessor::setNonRealtime(
+    bool shouldBeNonRealtime) noexcept {
+  juce::AudioProcessor::setNonRealtime(shouldBeNonRealtime);
+  if (!shouldBeNonRealtime) {
+    finishOfflineRender();
+  } else if (!offlineRendering.exchange(true)) {
+    collector.snapshotAndReset(); // the render's sidecar covers only the render
+  }
+}
+
+void MAStyleJuceDemoAudioProcessor::finishOfflineRender() {
+  if (!offlineRendering.exchange(false))
+    return;
+  const auto stats = collector.snapshotAndReset();
+  if (stats.samples == 0)
+    return;
+
+  SidecarMeta meta;
+  {
+    const std::lock_guard<std::mutex> lock(renderMetaMutex);
+    meta = renderMeta;
+  }
+  // Only queues: the writer thread does the file I/O. Called from the noexcept
+  // setNonRealtime, so a failed copy/queue drops this render's sidecar rather
+  // than escaping.
+  try {
+    meta.host += " (offline)";
+    writer.enqueue(stats, meta);
+  } catch (const std::exception &e) {
+    juce::Logger::writeToLog("MAStyleJuceDemo: offline sidecar not queued: " +
+                             juce::String(e.what()));
+  }
+}
+
+// Step modulation, split at step boundaries. Follows the host's PPQ position
+// while the transport plays (so steps land on the grid at any buffer size) and
+// free-runs at the fixed rate otherwise.
+void MAStyleJuceDemoAudioProcessor::applyStepModulation(
+    juce::AudioBuffer<float> &buffer) noexcept {
+  auto position = stepPhase;
+  auto stepsPerSample = stepDeltaPerSample;
+  if (auto *playHead = getPlayHead())
+    if (const auto info = playHead->getPosition(); info && info->getIsPlaying())
+      if (const auto ppq = info->getPpqPosition())
+        if (const auto bpm = info->getBpm(); bpm && *bpm > 0.0) {
+          position = *ppq * stepsPerBeat;
+          stepsPerSample = *bpm / 60.0 * stepsPerBeat / getSampleRate();
+        }
+
+  const auto numSamples = buffer.getNumSamples();
+  auto *const *channels = buffer.getArrayOfWritePointers();
+  const auto gainForStep = [this](int index) {
+    return 1.0f + 0.5f * params.steps[(size_t)index].load(); // up to +6 dB-ish
+  };
+  for (int offset = 0; offset < numSamples;) {
+    const auto n = juce::jmin(numSamples - offset, stepEnvelope.capacity());
+    const auto *env = stepEnvelope.render(position + offset * stepsPerSample, stepsPerSample,
+                                          numSteps, n, gainForStep);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+      juce::FloatVectorOperations::multiply(channels[ch] + offset, env, n);
+    offset += n;
+  }
+
+  stepPhase = std::fmod(position + numSamples * stepsPerSample, (double)numSteps);
+}
+
+// Recomputes the one-pole coefficient only when the (smoothed) cutoff moved.
+void MAStyleJuceDemoAudioProcessor::updateToneCoefficient(int numSamples) noexcept {
+  toneHz.setTargetValue(params.tone.load());
+  const auto hz = toneHz.skip(numSamples);
+  if (hz == lastToneHz)
+    return;
+  lastToneHz = hz;
+  toneAlpha = ma::dsp::OnePoleBank::coefficientFor(hz, getSampleRate());
 }
 
 bool MAStyleJuceDemoAudioProcessor::isBusesLayoutSupported(
     const BusesLayout &layouts) const {
-  return layouts.getMainInputChannelSet() == layouts.getMainOutputChannelSet();
+  // Any matching layout the tone bank can cover (up to 9.1.6).
+  const auto &main = layouts.getMainOutputChannelSet();
+  return layouts.getMainInputChannelSet() == main &&
+         main.size() <= ma::dsp::OnePoleBank::kMaxChannels;
 }
 
 void MAStyleJuceDemoAudioProcessor::processBlock(
@@ -80,81 +173,96 @@ void MAStyleJuceDemoAudioProcessor::processBlock(
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  auto *drive = state.getRawParameterValue("drive");
-  auto *mix = state.getRawParameterValue("mix");
-  auto *tone = state.getRawParameterValue("tone");
-
   auto block = juce::dsp::AudioBlock<float>(buffer);
   dryWet.pushDrySamples(block);
 
   // Simple drive + dry/wet (placeholder DSP, kept lightweight).
-  auto driveGain = juce::Decibels::decibelsToGain(drive->load());
-
-  // Step modulation: pick current step based on block time.
-  auto currentStepIndex = static_cast<size_t>(static_cast<int>(stepPhase) % numSteps);
-  stepPhase += stepDeltaPerSample * buffer.getNumSamples();
-  auto stepVal = stepParams[currentStepIndex] ? stepParams[currentStepIndex]->load() : 0.0f;
-  auto stepGain = 1.0f + (0.5f * stepVal); // up to +6 dB-ish
+  auto driveGain = juce::Decibels::decibelsToGain(params.drive.load());
 
-  driveGain *= stepGain;
-  buffer.applyGain(driveGain);
+  // Ramped rather than applied as one jump per block.
+  gain.setTarget(driveGain);
+  gain.apply(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+  applyStepModulation(buffer);
 
   // Lightweight tone tilt: one-pole LP per channel.
-  auto toneHz = tone->load();
-  auto alpha = 1.0f - std::exp(-2.0 * juce::MathConstants<double>::pi * (double)toneHz / getSampleRate());
-  auto* left = buffer.getWritePointer(0);
-  auto* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
-  for (int i = 0; i < buffer.getNumSamples(); ++i)
-  {
-      toneStateL += (float)alpha * (left[i] - toneStateL);
-      left[i] = toneStateL;
-      if (right)
-      {
-          toneStateR += (float)alpha * (right[i] - toneStateR);
-          right[i] = toneStateR;
-      }
-  }
+  updateToneCoefficient(buffer.getNumSamples());
+  toneFilter.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                     buffer.getNumSamples(), toneAlpha);
 
-  dryWet.setWetMixProportion(mix->load());
+  // DryWetMixer smooths the proportion itself.
+  dryWet.setWetMixProportion(params.mix.load());
   dryWet.mixWetSamples(block);
 
-  collector.push(buffer);
-
-  // RMS meter
-  auto numSamples = buffer.getNumSamples();
-  float sumSquares = 0.0f;
-  for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-    sumSquares += buffer.getRMSLevel(ch, 0, numSamples);
-  auto avg = sumSquares / juce::jmax(1, buffer.getNumChannels());
-  rmsMeter.setTargetValue(avg);
-  lastRms = rmsMeter.getNextValue();
+  // One stats pass feeds both the sidecar collector and the editor meter.
+  const auto *const *channels = buffer.getArrayOfReadPointers();
+  const auto numChannels = buffer.getNumChannels();
+  const auto numSamples = buffer.getNumSamples();
+  const auto stats = ma::dsp::computeBlockStats(channels, numChannels, numSamples);
+  collector.push(stats);
+  levelMeter.process(channels, numChannels, numSamples, stats);
 }
 
 juce::AudioProcessorEditor *MAStyleJuceDemoAudioProcessor::createEditor() {
+  applyPendingState();
   return new MAStyleJuceDemoAudioProcessorEditor(*this);
 }
 
 void MAStyleJuceDemoAudioProcessor::getStateInformation(
     juce::MemoryBlock &destData) {
-  auto stateTree = state.copyState();
-  std::unique_ptr<juce::XmlElement> xml(stateTree.createXml());
-  copyXmlToBinary(*xml, destData);
+  {
+    const std::lock_guard<std::mutex> lock(pendingStateMutex);
+    if (pendingState.isValid()) {
+      PluginState::write(pendingState, destData);
+      return;
+    }
+  }
+  PluginState::write(state.copyState(), destData);
 }
 
 void MAStyleJuceDemoAudioProcessor::setStateInformation(const void *data,
                                                         int sizeInBytes) {
-  std::unique_ptr<juce::XmlElement> xmlState(
-      getXmlFromBinary(data, sizeInBytes));
-  if (xmlState.get() != nullptr)
-    if (xmlState->hasTagName(state.state.getType()))
-      state.replaceState(juce::ValueTree::fromXml(*xmlState));
-}
-
-void MAStyleJuceDemoAudioProcessor::requestSidecar(const SidecarMeta &meta) {
-  auto stats = collector.snapshotAndReset();
-  writer.enqueue(stats, meta);
-  // Do not let the pool delete our stack-owned job.
-  pool.addJob(&writer, false);
+  auto tree = PluginState::read(data, sizeInBytes, state.state.getType());
+  if (!tree.isValid())
+    return;
+  {
+    const std::lock_guard<std::mutex> lock(pendingStateMutex);
+    pendingState = std::move(tree);
+  }
+  triggerAsyncUpdate();
+}
+
+/** Diffs the pending tree against the live parameters instead of
+    replaceState(), which rebuilds the APVTS tree and re-notifies every
+    attachment even when nothing changed. */
+void MAStyleJuceDemoAudioProcessor::applyPendingState() {
+  juce::ValueTree tree;
+  {
+    const std::lock_guard<std::mutex> lock(pendingStateMutex);
+    std::swap(tree, pendingState);
+  }
+  if (!tree.isValid())
+    return;
+  cancelPendingUpdate();
+
+  static const juce::Identifier paramType("PARAM"), idKey("id"), valueKey("value");
+  for (const auto &child : tree) {
+    if (!child.hasType(paramType))
+      continue;
+    auto *param = state.getParameter(child[idKey].toString());
+    if (param == nullptr || !child.hasProperty(valueKey))
+      continue;
+    const auto normalised = param->convertTo0to1((float)child[valueKey]);
+    if (std::abs(param->getValue() - normalised) > 1.0e-6f)
+      param->setValueNotifyingHost(normalised);
+  }
+}
+
+bool MAStyleJuceDemoAudioProcessor::requestSidecar(const SidecarMeta &meta) {
+  {
+    const std::lock_guard<std::mutex> lock(renderMetaMutex);
+    renderMeta = meta;
+  }
+  return writer.enqueue(collector.snapshotAndReset(), meta);
 }
 
 juce::AudioProcessor *JUCE_CALLTYPE createPluginFilter() {
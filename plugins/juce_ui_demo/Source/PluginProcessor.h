@@ -2,18 +2,31 @@
 
 #include <array>
 #include "FeatureCollector.h"
+#include "LevelMeter.h"
+#include "ParameterBindings.h"
+#include "PluginState.h"
 #include "SidecarWriter.h"
+#include "StepEnvelope.h"
+#include <ma/dsp/OnePole.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
-class MAStyleJuceDemoAudioProcessor : public juce::AudioProcessor {
+#include <mutex>
+
+class MAStyleJuceDemoAudioProcessor : public juce::AudioProcessor,
+                                      private juce::AsyncUpdater {
 public:
   MAStyleJuceDemoAudioProcessor();
-  ~MAStyleJuceDemoAudioProcessor() override;
+  ~MAStyleJuceDemoAudioProcessor() override = default;
 
   // AudioProcessor
   void prepareToPlay(double sampleRate, int samplesPerBlock) override;
-  void releaseResources() override {}
+  void releaseResources() override;
+  /** Offline bounces: entering non-realtime starts a fresh stats window, and
+      leaving it (or releaseResources mid-render) queues that render's sidecar
+      under the ids of the last manual snapshot. The collector is lossless at
+      any render speed, so nothing else changes. */
+  void setNonRealtime(bool shouldBeNonRealtime) noexcept override;
   bool isBusesLayoutSupported(const BusesLayout &layouts) const override;
   void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
 
@@ -32,29 +45,54 @@ public:
   const juce::String getProgramName(int) override { return {}; }
   void changeProgramName(int, const juce::String &) override {}
 
+  /** Binary state (PluginState.h). setStateInformation only decodes; the
+      tree is applied later on the message thread (or by prepareToPlay /
+      createEditor, whichever comes first), pushing just the parameters whose
+      value differs. A save before that returns the pending tree. */
   void getStateInformation(juce::MemoryBlock &destData) override;
   void setStateInformation(const void *data, int sizeInBytes) override;
 
   juce::AudioProcessorValueTreeState &getValueTreeState() { return state; }
-  float getLastRms() const { return lastRms; }
+  MeterChannel &getMeterChannel() { return levelMeter.getChannel(); }
   ProbeStats getStatsAndReset() { return collector.snapshotAndReset(); }
-  void requestSidecar(const SidecarMeta &meta);
+  // False when the writer's queue is full; retry later.
+  bool requestSidecar(const SidecarMeta &meta);
+  SidecarWriterMetrics getSidecarMetrics() const { return writer.getMetrics(); }
 
 private:
-  float onePoleToneSample(float x, float fc) noexcept;
+  void updateToneCoefficient(int numSamples) noexcept;
+  void applyStepModulation(juce::AudioBuffer<float> &buffer) noexcept;
+  void handleAsyncUpdate() override { applyPendingState(); }
+  void applyPendingState();
+  void finishOfflineRender();
 
   juce::AudioProcessorValueTreeState state;
   juce::dsp::DryWetMixer<float> dryWet;
-  juce::LinearSmoothedValue<float> rmsMeter;
-  float lastRms = 0.0f;
+  LevelMeter levelMeter;
   FeatureCollector collector;
   SidecarWriter writer;
-  juce::ThreadPool pool{1};
-  float toneStateL{0.0f}, toneStateR{0.0f};
-  double stepPhase{0.0};
+  std::mutex renderMetaMutex;
+  SidecarMeta renderMeta; // guarded by renderMetaMutex
+  std::atomic<bool> offlineRendering{false};
+  std::mutex pendingStateMutex;
+  juce::ValueTree pendingState; // guarded by pendingStateMutex
+  ma::dsp::OnePoleBank toneFilter; // every bus channel, SIMD across channels
+  double stepPhase{0.0};         // free-running position (steps) when not synced
   double stepDeltaPerSample{0.0};
   static constexpr int numSteps = 8;
-  std::array<std::atomic<float> *, numSteps> stepParams{};
+  static constexpr double stepsPerBeat = 4.0; // sixteenth notes under host sync
+
+  // Resolved once in the constructor; the audio thread only loads atomics.
+  struct Parameters {
+    BoundParameter drive, mix, tone;
+    std::array<BoundParameter, numSteps> steps;
+  } params;
+
+  GainRamp gain; // drive, ramped per sample
+  StepEnvelope stepEnvelope;
+  juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> toneHz;
+  float lastToneHz{-1.0f};
+  float toneAlpha{1.0f};
 
   juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/** Plugin state blob: an 8-byte header (magic, format version) followed by the
+    APVTS tree in ValueTree's binary encoding (`writeToStream`, like
+    juce_probe). Much smaller and faster to parse than the XML that older
+    builds saved; `read()` still accepts those blobs and migrates them. */
+namespace PluginState {
+inline constexpr int kMagic = 0x5453414d; // "MAST", little-endian
+inline constexpr int kVersion = 1;
+inline constexpr int kLegacyXmlVersion = 0; // copyXmlToBinary blobs (<= 0.1.1)
+
+inline void write(const juce::ValueTree &tree, juce::MemoryBlock &dest) {
+  juce::MemoryOutputStream out(dest, false);
+  out.writeInt(kMagic);
+  out.writeInt(kVersion);
+  tree.writeToStream(out);
+}
+
+/** Brings a tree saved by `fromVersion` up to the current layout. Add a case
+    per format bump; they fall through so old blobs take every step. */
+inline juce::ValueTree migrate(juce::ValueTree tree, int fromVersion) {
+  switch (fromVersion) {
+  case kLegacyXmlVersion: // same tree, only the encoding changed
+  default:
+    break;
+  }
+  return tree;
+}
+
+/** Decodes a binary or legacy XML blob. Returns an invalid tree for garbage,
+    a blob from a newer format version, or a tree not of `expectedType`. */
+inline juce::ValueTree read(const void *data, int sizeInBytes,
+                            const juce::Identifier &expectedType) {
+  if (data == nullptr || sizeInBytes <= 0)
+    return {};
+
+  juce::ValueTree tree;
+  juce::MemoryInputStream in(data, (size_t)sizeInBytes, false);
+  if (sizeInBytes >= 8 && in.readInt() == kMagic) {
+    const auto version = in.readInt();
+    if (version > kVersion)
+      return {};
+    tree = migrate(juce::ValueTree::readFromStream(in), version);
+  } else if (auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes)) {
+    tree = migrate(juce::ValueTree::fromXml(*xml), kLegacyXmlVersion);
+  }
+  return tree.hasType(expectedType) ? tree : juce::ValueTree();
+}
+} // namespace PluginState
@@ -3,6 +3,11 @@
 #include "FeatureCollector.h"
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
+#include <ma/index/SidecarIndex.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 struct SidecarMeta {
   juce::String trackId;
@@ -11,65 +16,197 @@ struct SidecarMeta {
   juce::String version = "juce_probe_features_v1";
 };
 
-class SidecarWriter : public juce::ThreadPoolJob {
+/** Counters for the snapshot pipeline; latency is enqueue -> file flushed. */
+struct SidecarWriterMetrics {
+  int64_t written = 0;
+  int64_t rejected = 0; // queue full (back-pressure) or writer stopping
+  int64_t failed = 0;
+  double lastLatencyMs = 0.0;
+  double maxLatencyMs = 0.0;
+};
+
+/** Snapshot pipeline with its own writer thread. Any thread except audio may
+    enqueue (multi-producer); a bounded queue applies back-pressure by rejecting
+    requests once `kQueueCapacity` are pending, so a slow volume can never grow
+    memory. The writer drains everything pending in one batch: each track
+    directory is created once per batch, every file is written and fsynced
+    (FileOutputStream::flush), indexed in the data root's append-only
+    `juce_probe_index.bin` (ma/index/SidecarIndex.h), and per-snapshot latency
+    is recorded. */
+class SidecarWriter : private juce::Thread {
 public:
-  SidecarWriter() : ThreadPoolJob("SidecarWriter") {}
+  static constexpr int kQueueCapacity = 16;
+
+  SidecarWriter() : juce::Thread("SidecarWriter") {}
+  ~SidecarWriter() override { stop(); }
 
   static juce::File defaultRoot() {
     auto home = juce::File::getSpecialLocation(juce::File::userHomeDirectory);
     return home.getChildFile("music-advisor/data/features_output/juce_probe");
   }
 
-  void enqueue(const ProbeStats &stats, const SidecarMeta &meta) {
-    juce::SpinLock::ScopedLockType lock(queueLock);
-    pendingStats = stats;
-    pendingMeta = meta;
-    hasWork = true;
+  /** Returns false (and counts a rejection) when the queue is full or a
+      stop() is in progress. Starts the writer thread on first use (and again
+      after stop()). */
+  bool enqueue(const ProbeStats &stats, const SidecarMeta &meta) {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      if (stopping || pending.size() >= (size_t)kQueueCapacity) {
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      pending.push_back({stats, meta, juce::Time::getMillisecondCounterHiRes(),
+                         juce::Time::getCurrentTime()});
+    }
+    if (!isThreadRunning())
+      startThread(juce::Thread::Priority::background);
+    notify();
+    return true;
   }
 
-  JobStatus runJob() override {
-    if (!hasWork)
-      return juce::ThreadPoolJob::jobHasFinished;
-    ProbeStats statsCopy;
-    SidecarMeta metaCopy;
+  /** Writes whatever is still queued, then ends the thread (releaseResources),
+      so idle instances hold no thread. Enqueues that race with it are
+      rejected rather than left behind the writer's final drain. */
+  void stop() {
     {
-      juce::SpinLock::ScopedLockType lock(queueLock);
-      statsCopy = pendingStats;
-      metaCopy = pendingMeta;
-      hasWork = false;
+      std::lock_guard<std::mutex> lock(queueMutex);
+      stopping = true;
     }
-    writeSidecar(statsCopy, metaCopy);
-    return juce::ThreadPoolJob::jobHasFinished;
+    stopThread(5000);
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = false;
+  }
+
+  SidecarWriterMetrics getMetrics() const {
+    SidecarWriterMetrics m;
+    m.written = written.load(std::memory_order_relaxed);
+    m.rejected = rejected.load(std::memory_order_relaxed);
+    m.failed = failed.load(std::memory_order_relaxed);
+    m.lastLatencyMs = lastLatencyMs.load(std::memory_order_relaxed);
+    m.maxLatencyMs = maxLatencyMs.load(std::memory_order_relaxed);
+    return m;
   }
 
 private:
-  void writeSidecar(const ProbeStats &stats, const SidecarMeta &meta) {
-    juce::DynamicObject obj;
-    obj.setProperty("version", meta.version);
-    obj.setProperty("track_id", meta.trackId);
-    obj.setProperty("session_id", meta.sessionId);
-    obj.setProperty("host", meta.host);
-    obj.setProperty("sample_rate", stats.sampleRate);
-
-    juce::DynamicObject *feats = new juce::DynamicObject();
-    feats->setProperty("rms", stats.rms);
-    feats->setProperty("peak", stats.peak);
-    feats->setProperty("crest", stats.crest);
-    obj.setProperty("features", juce::var(feats));
-    auto json = juce::JSON::toString(juce::var(&obj), true);
-
-    auto root = defaultRoot();
-    auto trackDir =
-        root.getChildFile(meta.trackId.isEmpty() ? "untitled" : meta.trackId);
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true);
-    auto outDir = trackDir.getChildFile(timestamp);
-    outDir.createDirectory();
-    auto outFile = outDir.getChildFile("juce_probe_features.json");
-    outFile.replaceWithText(json);
+  struct Job {
+    ProbeStats stats;
+    SidecarMeta meta;
+    double enqueuedMs = 0.0;
+    juce::Time requestedAt;
+  };
+
+  void run() override {
+    std::vector<Job> batch;
+    batch.reserve((size_t)kQueueCapacity);
+    for (;;) {
+      // Read the flag before draining so a stop() never strands queued jobs.
+      const auto exiting = threadShouldExit();
+      {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        batch.swap(pending);
+      }
+      if (!batch.empty()) {
+        writeBatch(batch);
+        batch.clear();
+      } else if (exiting) {
+        // stop() has closed the queue, so an empty check under the lock is final.
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (pending.empty())
+          return;
+      } else {
+        wait(-1);
+      }
+    }
+  }
+
+  void writeBatch(const std::vector<Job> &batch) {
+    juce::StringArray createdDirs;
+    for (const auto &job : batch) {
+      auto trackDir = defaultRoot().getChildFile(
+          job.meta.trackId.isEmpty() ? "untitled" : job.meta.trackId);
+      if (!createdDirs.contains(trackDir.getFullPathName())) {
+        trackDir.createDirectory();
+        createdDirs.add(trackDir.getFullPathName());
+      }
+
+      // Unique per request: several snapshots in the same second keep their own folder.
+      auto outDir = trackDir.getNonexistentChildFile(
+          job.requestedAt.toString(true, true), {}, false);
+      const auto outFile = outDir.getChildFile("juce_probe_features.json");
+      const auto ok =
+          outDir.createDirectory().wasOk() && writeSidecar(outFile, job);
+      if (!ok) {
+        failed.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      appendIndexRecord(outFile, job);
+
+      const auto latency = juce::Time::getMillisecondCounterHiRes() - job.enqueuedMs;
+      written.fetch_add(1, std::memory_order_relaxed);
+      lastLatencyMs.store(latency, std::memory_order_relaxed);
+      if (latency > maxLatencyMs.load(std::memory_order_relaxed))
+        maxLatencyMs.store(latency, std::memory_order_relaxed); // single writer
+    }
+  }
+
+  /** Best effort: a snapshot missing from the index is still found by walking
+      the folders. The demo has no loudness/tempo stage, so those stay NaN. */
+  static void appendIndexRecord(const juce::File &outFile, const Job &job) {
+    auto record = ma::index::makeRecord();
+    record.writtenAtMs = job.requestedAt.toMilliseconds();
+    record.sampleRate = job.stats.sampleRate;
+    if (job.stats.channels > 0 && job.stats.sampleRate > 0.0)
+      record.durationSec = (double)job.stats.samples /
+                           ((double)job.stats.channels * job.stats.sampleRate);
+    if (job.stats.peak > 0.0) {
+      record.peakDb = juce::Decibels::gainToDecibels(job.stats.peak);
+      record.integratedRmsDb = juce::Decibels::gainToDecibels(job.stats.rms);
+      record.crestDb = juce::Decibels::gainToDecibels(job.stats.crest);
+    }
+    ma::index::setField(record.source, "juce_ui_demo");
+    const auto trackId =
+        job.meta.trackId.isEmpty() ? juce::String("untitled") : job.meta.trackId;
+    if (!ma::index::setField(record.trackId, trackId.toStdString()) ||
+        !ma::index::setField(record.sessionId, job.meta.sessionId.toStdString()))
+      record.flags |= ma::index::kFlagIdTruncated;
+    const auto relative =
+        outFile.getRelativePathFrom(defaultRoot()).replaceCharacter('\\', '/');
+    if (!ma::index::setField(record.relativePath, relative.toStdString()))
+      record.flags |= ma::index::kFlagPathTruncated;
+
+    const auto index = defaultRoot().getChildFile(ma::index::kIndexFileName);
+    ma::index::appendRecord(index.getFullPathName().toStdString(), record);
+  }
+
+  static bool writeSidecar(const juce::File &outFile, const Job &job) {
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+    obj->setProperty("version", job.meta.version);
+    obj->setProperty("track_id", job.meta.trackId);
+    obj->setProperty("session_id", job.meta.sessionId);
+    obj->setProperty("host", job.meta.host);
+    obj->setProperty("sample_rate", job.stats.sampleRate);
+
+    juce::DynamicObject::Ptr feats = new juce::DynamicObject();
+    feats->setProperty("rms", job.stats.rms);
+    feats->setProperty("peak", job.stats.peak);
+    feats->setProperty("crest", job.stats.crest);
+    obj->setProperty("features", juce::var(feats.get()));
+    const auto json = juce::JSON::toString(juce::var(obj.get()), true);
+
+    juce::FileOutputStream out(outFile);
+    if (!out.openedOk())
+      return false;
+    out.setPosition(0);
+    out.truncate();
+    out.writeText(json, false, false, nullptr);
+    out.flush(); // fsync on POSIX, FlushFileBuffers on Windows
+    return out.getStatus().wasOk();
   }
 
-  juce::SpinLock queueLock;
-  ProbeStats pendingStats;
-  SidecarMeta pendingMeta;
-  bool hasWork{false};
+  std::mutex queueMutex;
+  std::vector<Job> pending;
+  bool stopping = false; // guarded by queueMutex; enqueue() refuses while set
+
+  std::atomic<int64_t> written{0}, rejected{0}, failed{0};
+  std::atomic<double> lastLatencyMs{0.0}, maxLatencyMs{0.0};
 };
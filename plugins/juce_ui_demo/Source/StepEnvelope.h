@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <cmath>
+#include <vector>
+
+/** Sample-accurate step-sequencer gain envelope. A block is split at every
+    step boundary that falls inside it; each segment is a short linear ramp to
+    the step's gain followed by a vectorised fill, so the envelope is identical
+    for any host buffer size and the apply pass is one multiply per channel. */
+class StepEnvelope {
+public:
+  // Message thread (prepareToPlay). `rampSeconds` de-clicks step edges.
+  void prepare(double sampleRate, int maxBlockSize, double rampSeconds = 0.002) {
+    envelope.assign((size_t)juce::jmax(1, maxBlockSize), 1.0f);
+    rampSamples = juce::jmax(1, (int)std::lround(sampleRate * rampSeconds));
+    level = rampTarget = -1.0f;
+    rampLeft = 0;
+  }
+
+  int capacity() const noexcept { return (int)envelope.size(); }
+
+  /** Audio thread. Renders `numSamples` (<= capacity()) of gain, starting at
+      step position `startStep` (fractional, in steps) and advancing
+      `stepsPerSample`. `gainForStep(index)` maps a step index in
+      [0, numSteps) to its gain. */
+  template <typename GainForStep>
+  const float *render(double startStep, double stepsPerSample, int numSteps,
+                      int numSamples, GainForStep &&gainForStep) noexcept {
+    jassert(numSamples <= capacity());
+    auto *out = envelope.data();
+    for (int i = 0; i < numSamples;) {
+      const auto pos = startStep + (double)i * stepsPerSample;
+      // Tolerance keeps a boundary on the same sample however the block was cut.
+      const auto whole = std::floor(pos + kBoundaryEpsilon);
+      const auto index = (int)(((long long)whole % numSteps + numSteps) % numSteps);
+
+      // Samples until the next boundary: sample j belongs to step floor(pos_j).
+      auto seg = numSamples - i;
+      if (stepsPerSample > 0.0)
+        seg = juce::jlimit(1, seg, (int)std::ceil((whole + 1.0 - pos) / stepsPerSample -
+                                                  kBoundaryEpsilon / stepsPerSample));
+
+      const auto target = gainForStep(index);
+      if (level < 0.0f) // first block after prepare(): no fade-in
+        level = rampTarget = target;
+      if (target != rampTarget) {
+        rampTarget = target;
+        rampLeft = rampSamples;
+        rampIncrement = (target - level) / (float)rampSamples;
+      }
+
+      const auto ramp = juce::jmin(seg, rampLeft);
+      for (int k = 0; k < ramp; ++k)
+        out[i + k] = level + rampIncrement * (float)(k + 1);
+      level += rampIncrement * (float)ramp;
+      rampLeft -= ramp;
+      if (rampLeft == 0)
+        level = rampTarget;
+
+      juce::FloatVectorOperations::fill(out + i + ramp, level, seg - ramp);
+      i += seg;
+    }
+    return out;
+  }
+
+private:
+  static constexpr double kBoundaryEpsilon = 1.0e-9; // steps
+
+  std::vector<float> envelope;
+  int rampSamples = 1;
+  float level = -1.0f, rampTarget = -1.0f, rampIncrement = 0.0f;
+  int rampLeft = 0;
+};
@@ -0,0 +1,131 @@
+// mastyle_demo_bench: times MAStyleJuceDemoAudioProcessor::processBlock
+// headlessly (no plugin wrapper, no host) across block sizes and bus layouts.
+//
+//   mastyle_demo_bench [--filter <substring>]
+//
+// One JSON object per case on stdout (see ma/bench/Bench.h):
+//   process_block:<layout>            static parameters
+//   process_block_automated:<layout>  drive/tone/mix moved every block, as under
+//                                     dense host automation
+//   instantiate                       construct + destroy, as during a plugin scan
+//   prepare_release                   prepareToPlay + releaseResources at 512 samples
+
+#include "../PluginProcessor.h"
+
+#include <ma/bench/Bench.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+constexpr double kSampleRate = 48000.0;
+// Per-instance budget for a host scan / project open (construct + destroy).
+constexpr double kInstantiateBudgetUs = 1000.0;
+
+struct Layout {
+  const char *name;
+  juce::AudioChannelSet set;
+};
+
+void fillSignal(juce::AudioBuffer<float> &buffer) {
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto *data = buffer.getWritePointer(ch);
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+      data[i] = 0.25f * std::sin(0.011f * (float)(i * (ch + 1)));
+  }
+}
+
+void runCase(const ma::bench::Reporter &reporter, const Layout &layout, int block,
+             bool automate) {
+  MAStyleJuceDemoAudioProcessor processor;
+  juce::AudioProcessor::BusesLayout buses;
+  buses.inputBuses.add(layout.set);
+  buses.outputBuses.add(layout.set);
+  if (!processor.setBusesLayout(buses))
+    return;
+  processor.prepareToPlay(kSampleRate, block);
+
+  auto &vts = processor.getValueTreeState();
+  auto *drive = vts.getParameter("drive");
+  auto *tone = vts.getParameter("tone");
+  auto *mix = vts.getParameter("mix");
+
+  const auto numChannels = layout.set.size();
+  juce::AudioBuffer<float> buffer(numChannels, block);
+  juce::MidiBuffer midi;
+  int counter = 0;
+  const auto r = ma::bench::measure([&] {
+    if (automate) {
+      const auto x = 0.5f + 0.5f * std::sin(0.05f * (float)counter++);
+      drive->setValue(x);
+      tone->setValue(1.0f - x);
+      mix->setValue(x);
+    }
+    fillSignal(buffer);
+    processor.processBlock(buffer, midi);
+  });
+  processor.releaseResources();
+
+  reporter.report(std::string(automate ? "process_block_automated:" : "process_block:") +
+                      layout.name,
+                  {{"block", block}, {"channels", numChannels}}, r,
+                  {{"ns_per_sample", r.nsPerIteration / (double)(block * numChannels)},
+                   {"rt_cpu_pct",
+                    100.0 * r.nsPerIteration / ((double)block / kSampleRate * 1.0e9)}});
+}
+void runLifecycleCases(const ma::bench::Reporter &reporter, const juce::String &filter) {
+  if (filter.isEmpty() || juce::String("instantiate").contains(filter)) {
+    const auto r = ma::bench::measure([] { MAStyleJuceDemoAudioProcessor processor; });
+    const auto us = r.nsPerIteration / 1000.0;
+    reporter.report("instantiate", {}, r,
+                    {{"us_per_instance", us},
+                     {"budget_us", kInstantiateBudgetUs},
+                     {"within_budget", us <= kInstantiateBudgetUs ? 1.0 : 0.0}});
+  }
+  if (filter.isEmpty() || juce::String("prepare_release").contains(filter)) {
+    MAStyleJuceDemoAudioProcessor processor;
+    const auto r = ma::bench::measure([&] {
+      processor.prepareToPlay(kSampleRate, 512);
+      processor.releaseResources();
+    });
+    reporter.report("prepare_release", {{"block", 512}}, r,
+                    {{"us_per_cycle", r.nsPerIteration / 1000.0}});
+  }
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  juce::String filter;
+  for (int i = 1; i < argc; ++i) {
+    const juce::String arg(argv[i]);
+    if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else {
+      std::fprintf(stderr, "usage: mastyle_demo_bench [--filter <substring>]\n");
+      return 2;
+    }
+  }
+
+  // APVTS and AudioProcessor expect a message manager to exist.
+  juce::ScopedJuceInitialiser_GUI juceInit;
+  const ma::bench::Reporter reporter("juce_ui_demo");
+  const std::vector<Layout> layouts{
+      {"mono", juce::AudioChannelSet::mono()},
+      {"stereo", juce::AudioChannelSet::stereo()},
+      {"5.1", juce::AudioChannelSet::create5point1()},
+      {"7.1", juce::AudioChannelSet::create7point1()},
+      {"7.1.4", juce::AudioChannelSet::create7point1point4()}};
+
+  for (const bool automate : {false, true})
+    for (const auto &layout : layouts) {
+      const auto name = juce::String(automate ? "process_block_automated:" : "process_block:") +
+                        layout.name;
+      if (filter.isNotEmpty() && !name.contains(filter))
+        continue;
+      // fillSignal is included in the timing; it is a small constant next to processBlock.
+      for (int block = 32; block <= 4096; block *= 2)
+        runCase(reporter, layout, block, automate);
+    }
+  runLifecycleCases(reporter, filter);
+  return 0;
+}
@@ -25,27 +25,27 @@ std::unique_ptr<juce::Drawable> makeBadgeDrawable() {
 
 AnimatedSvgBadge::AnimatedSvgBadge() {
   drawable = makeBadgeDrawable();
-  startTimerHz(30);
 }
 
 void AnimatedSvgBadge::paint(juce::Graphics &g) {
-  g.fillAll(juce::Colour::fromRGBA(0, 0, 0, 0));
   if (!drawable)
     return;
   auto b = getLocalBounds().toFloat().reduced(4.0f);
   auto alpha = 0.75f + 0.25f * std::sin(phase);
-  drawable->setTransform(juce::AffineTransform::rotation(0.05f * std::sin(phase), b.getCentreX(), b.getCentreY())
-                             .scaled(1.0f + 0.02f * std::sin(phase * 0.5f), 1.0f + 0.02f * std::sin(phase * 0.5f),
-                                     b.getCentreX(), b.getCentreY()));
-  drawable->draw(g, alpha);
+  const auto motion =
+      juce::AffineTransform::rotation(0.05f * std::sin(phase), b.getCentreX(), b.getCentreY())
+          .scaled(1.0f + 0.02f * std::sin(phase * 0.5f), 1.0f + 0.02f * std::sin(phase * 0.5f),
+                  b.getCentreX(), b.getCentreY());
+  g.setOpacity(alpha);
+  sprite.draw(
+      g, getLocalBounds(),
+      [this](juce::Graphics &sg) {
+        drawable->drawWithin(sg, getLocalBounds().toFloat(), juce::RectanglePlacement::centred, 1.0f);
+      },
+      motion);
 }
 
-void AnimatedSvgBadge::resized() {
-  if (drawable)
-    drawable->setBounds(getLocalBounds().toFloat().toNearestInt());
-}
-
-void AnimatedSvgBadge::timerCallback() {
-  phase += 0.1f;
+void AnimatedSvgBadge::animationTick(double deltaSec) {
+  phase += (float)(deltaSec * 3.0); // 0.1 rad per frame at 30 Hz
   repaint();
 }
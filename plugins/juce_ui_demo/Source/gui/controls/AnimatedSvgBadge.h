@@ -1,16 +1,18 @@
 #pragma once
 
 #include <juce_gui_extra/juce_gui_extra.h>
+#include "AnimationScheduler.h"
 #include "GuiStyle.h"
+#include "LayerCache.h"
 
-class AnimatedSvgBadge : public juce::Component, private juce::Timer {
+class AnimatedSvgBadge : public juce::Component, public AnimationScheduler::Client {
 public:
   AnimatedSvgBadge();
   void paint(juce::Graphics &g) override;
-  void resized() override;
+  void animationTick(double deltaSec) override;
 
 private:
-  void timerCallback() override;
   std::unique_ptr<juce::Drawable> drawable;
+  LayerCache sprite; // SVG rendered once per size/scale, then only transformed
   float phase = 0.0f;
 };
@@ -0,0 +1,24 @@
+#include "AnimationScheduler.h"
+
+AnimationScheduler::AnimationScheduler(juce::Component &host, double maxRateHz)
+    : hostComponent(host), minIntervalMs(1000.0 / juce::jmax(1.0, maxRateHz)),
+      vblank(&host, [this] { onVBlank(); }) {}
+
+void AnimationScheduler::add(Client &client) { clients.addIfNotAlreadyThere(&client); }
+
+void AnimationScheduler::remove(Client &client) { clients.removeFirstMatchingValue(&client); }
+
+void AnimationScheduler::onVBlank() {
+  const auto nowMs = juce::Time::getMillisecondCounterHiRes();
+  if (clients.isEmpty() || !hostComponent.isShowing()) {
+    lastTickMs = 0.0; // resume without a large delta
+    return;
+  }
+  if (lastTickMs > 0.0 && nowMs - lastTickMs < minIntervalMs)
+    return;
+
+  const auto deltaSec = lastTickMs > 0.0 ? (nowMs - lastTickMs) / 1000.0 : minIntervalMs / 1000.0;
+  lastTickMs = nowMs;
+  for (auto *client : clients)
+    client->animationTick(deltaSec);
+}
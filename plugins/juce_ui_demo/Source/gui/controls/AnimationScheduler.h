@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+
+/** One display-synced tick per editor, shared by every animated control.
+    Driven by juce::VBlankAttachment on the host component and throttled to
+    `maxRateHz`; ticks stop while the host is not showing (editor closed or
+    minimised) or when no client is subscribed. Clients repaint only what
+    actually changed. */
+class AnimationScheduler {
+public:
+  struct Client {
+    virtual ~Client() = default;
+    /** Message thread. `deltaSec` is the time since this client's previous tick. */
+    virtual void animationTick(double deltaSec) = 0;
+  };
+
+  explicit AnimationScheduler(juce::Component &host, double maxRateHz = 30.0);
+
+  void add(Client &client);
+  void remove(Client &client);
+
+private:
+  void onVBlank();
+
+  juce::Component &hostComponent;
+  juce::Array<Client *> clients;
+  double minIntervalMs;
+  double lastTickMs = 0.0;
+  juce::VBlankAttachment vblank;
+};
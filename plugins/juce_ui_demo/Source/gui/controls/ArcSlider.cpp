@@ -16,11 +16,27 @@ ArcSlider::ArcSlider(juce::AudioProcessorValueTreeState &vts,
 
   attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
       vts, param.paramID, slider);
+  slider.addListener(this);
+}
 
-  startTimerHz(30);
+juce::Point<float> ArcSlider::headPosition() const {
+  auto inner = getLocalBounds().toFloat().reduced(16.0f);
+  auto centre = inner.getCentre();
+  auto radius = juce::jmin(inner.getWidth(), inner.getHeight()) * 0.5f - 8.0f;
+  const auto norm = (float)slider.getValue() / (float)slider.getMaximum();
+  const auto angle = juce::MathConstants<float>::pi * (1.1f + norm * 0.8f);
+  return {centre.x + radius * std::cos(angle), centre.y + radius * std::sin(angle)};
 }
 
-void ArcSlider::paint(juce::Graphics &g) {
+// Covers the halo at its largest pulse (radius 6 * 1.5) plus antialiasing.
+juce::Rectangle<int> ArcSlider::headDirtyArea() const {
+  const auto head = headPosition();
+  return juce::Rectangle<float>(head.x - 10.0f, head.y - 10.0f, 20.0f, 20.0f)
+      .getSmallestIntegerContainer();
+}
+
+// Panel, border and background track, rasterised through `chrome`.
+void ArcSlider::paintChrome(juce::Graphics &g) const {
   auto b = getLocalBounds().toFloat().reduced(6.0f);
   auto inner = b.reduced(10.0f);
   auto centre = inner.getCentre();
@@ -40,6 +56,14 @@ void ArcSlider::paint(juce::Graphics &g) {
                    true);
   g.setColour(guiBorder().withAlpha(0.4f));
   g.strokePath(bg, juce::PathStrokeType(3.0f));
+}
+
+void ArcSlider::paint(juce::Graphics &g) {
+  chrome.draw(g, getLocalBounds(), [this](juce::Graphics &cg) { paintChrome(cg); });
+
+  auto inner = getLocalBounds().toFloat().reduced(16.0f);
+  auto centre = inner.getCentre();
+  auto radius = juce::jmin(inner.getWidth(), inner.getHeight()) * 0.5f - 8.0f;
 
   // Value arc
   const auto norm = (float)slider.getValue() / (float)slider.getMaximum();
@@ -51,9 +75,7 @@ void ArcSlider::paint(juce::Graphics &g) {
   g.strokePath(arc, juce::PathStrokeType(4.0f, juce::PathStrokeType::curved));
 
   // Moving head
-  const auto headAngle = end;
-  juce::Point<float> head(centre.x + radius * std::cos(headAngle),
-                          centre.y + radius * std::sin(headAngle));
+  const auto head = headPosition();
   auto headRadius = 5.0f + 1.0f * std::sin(phase);
   g.setColour(guiHalo());
   g.fillEllipse(head.x - headRadius * 1.5f, head.y - headRadius * 1.5f,
@@ -69,7 +91,7 @@ void ArcSlider::resized() {
   slider.setBounds(r);
 }
 
-void ArcSlider::timerCallback() {
-  phase += 0.12f;
-  repaint();
+void ArcSlider::animationTick(double deltaSec) {
+  phase += (float)(deltaSec * 3.6); // 0.12 rad per frame at 30 Hz
+  repaint(headDirtyArea());
 }
@@ -2,18 +2,28 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "AnimationScheduler.h"
 #include "GuiStyle.h"
+#include "LayerCache.h"
 
 // Animated arc slider: shows value as a sweeping arc with a moving head.
-class ArcSlider : public juce::Component, private juce::Timer {
+// Value changes repaint the whole control; the head pulse repaints only the head.
+class ArcSlider : public juce::Component,
+                  public AnimationScheduler::Client,
+                  private juce::Slider::Listener {
 public:
   ArcSlider(juce::AudioProcessorValueTreeState &vts,
             juce::RangedAudioParameter &param);
   void paint(juce::Graphics &g) override;
   void resized() override;
+  void animationTick(double deltaSec) override;
 
 private:
-  void timerCallback() override;
+  void sliderValueChanged(juce::Slider *) override { repaint(); }
+  void paintChrome(juce::Graphics &g) const;
+  juce::Point<float> headPosition() const;
+  juce::Rectangle<int> headDirtyArea() const;
+  LayerCache chrome;
   juce::Slider slider;
   juce::Label label;
   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <juce_graphics/juce_graphics.h>
+#include <ma/tokens/MaTokens.h>
 
-inline juce::Colour guiPanel() { return juce::Colour::fromRGB(20, 26, 33); }
-inline juce::Colour guiAccent() { return juce::Colour::fromRGB(65, 156, 255); }
-inline juce::Colour guiBorder() { return juce::Colour::fromRGB(60, 70, 80); }
-inline juce::Colour guiHalo() { return juce::Colour::fromRGBA(65, 156, 255, 60); }
+// Resolved from the MAStyle design tokens at build time (see plugins/common).
+inline juce::Colour guiPanel() { return juce::Colour(ma::tokens::colour::panel); }
+inline juce::Colour guiAccent() { return juce::Colour(ma::tokens::colour::primary); }
+// The token border is translucent white; flatten it onto the panel so callers
+// can keep using withAlpha() on an opaque colour.
+inline juce::Colour guiBorder() { return guiPanel().overlaidWith(juce::Colour(ma::tokens::colour::border)); }
+inline juce::Colour guiHalo() { return juce::Colour(ma::tokens::colour::primary).withAlpha((juce::uint8)60); }
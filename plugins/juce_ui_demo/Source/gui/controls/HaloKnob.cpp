@@ -18,7 +18,8 @@ HaloKnob::HaloKnob(juce::AudioProcessorValueTreeState &vts,
       vts, param.paramID, slider);
 }
 
-void HaloKnob::paint(juce::Graphics &g) {
+// Panel, border and halo: only the value arc changes between repaints.
+void HaloKnob::paintChrome(juce::Graphics &g) const {
   auto bounds = getLocalBounds().toFloat();
   auto inner = bounds.reduced(8.0f);
   auto center = inner.getCentre();
@@ -32,7 +33,12 @@ void HaloKnob::paint(juce::Graphics &g) {
   g.setColour(guiHalo());
   g.fillEllipse(center.x - radius - 6.0f, center.y - radius - 6.0f,
                 2 * (radius + 6.0f), 2 * (radius + 6.0f));
+}
+
+void HaloKnob::paint(juce::Graphics &g) {
+  chrome.draw(g, getLocalBounds(), [this](juce::Graphics &cg) { paintChrome(cg); });
 
+  auto inner = getLocalBounds().toFloat().reduced(8.0f);
   auto knobArea = inner.reduced(12.0f);
   auto angle = juce::MathConstants<float>::pi * 1.2f;
   auto start = juce::MathConstants<float>::pi * 1.7f;
@@ -3,6 +3,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "GuiStyle.h"
+#include "LayerCache.h"
 
 class HaloKnob : public juce::Component {
 public:
@@ -12,6 +13,9 @@ public:
   void resized() override;
 
 private:
+  void paintChrome(juce::Graphics &g) const;
+
+  LayerCache chrome;
   juce::Slider slider;
   juce::Label label;
   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
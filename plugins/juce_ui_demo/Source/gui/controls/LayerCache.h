@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/** Static chrome rasterised once per component size and display scale.
+    `draw` re-renders through `render` only when the size or the context's
+    physical pixel scale changes (or after invalidate()), then blits the
+    image 1:1 onto device pixels; `motion` (logical coordinates, applied after
+    placement) lets a sprite move without re-rendering. Honours g's opacity.
+    Message thread only. */
+class LayerCache {
+public:
+  template <typename RenderFn>
+  void draw(juce::Graphics &g, juce::Rectangle<int> area, RenderFn &&render,
+            const juce::AffineTransform &motion = {}) {
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!image.isValid() || area.getWidth() != width || area.getHeight() != height ||
+        scale != cachedScale) {
+      width = area.getWidth();
+      height = area.getHeight();
+      cachedScale = scale;
+      if (width <= 0 || height <= 0)
+        return;
+      image = juce::Image(juce::Image::ARGB, juce::roundToInt((float)width * scale),
+                          juce::roundToInt((float)height * scale), true);
+      juce::Graphics ig(image);
+      ig.addTransform(juce::AffineTransform::scale(scale));
+      render(ig);
+    }
+    if (image.isValid())
+      g.drawImageTransformed(image,
+                             juce::AffineTransform::scale(1.0f / cachedScale)
+                                 .translated((float)area.getX(), (float)area.getY())
+                                 .followedBy(motion));
+  }
+
+  /** Forces the next draw() to re-render, e.g. after a style change. */
+  void invalidate() { image = {}; }
+
+private:
+  juce::Image image;
+  int width = 0, height = 0;
+  float cachedScale = 0.0f;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ma/dsp/TripleBuffer.h>
+
+#include <limits>
+
+/** Latest meter values published by the audio thread (see LevelMeter). Linear
+    gain for peak/RMS, LUFS for the momentary (400 ms) loudness. */
+struct MeterReading {
+  float peak = 0.0f;
+  float rms = 0.0f;
+  float momentaryLufs = -std::numeric_limits<float>::infinity();
+};
+
+using MeterChannel = ma::dsp::TripleBuffer<MeterReading>;
@@ -18,7 +18,8 @@ MiniEnvelope::MiniEnvelope(juce::AudioProcessorValueTreeState &vts,
   releaseAttach =
       std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
           processorState, release.paramID, releaseSlider);
-  startTimerHz(30);
+  attackSlider.addListener(this);
+  releaseSlider.addListener(this);
 }
 
 void MiniEnvelope::paint(juce::Graphics &g) {
@@ -49,5 +50,3 @@ void MiniEnvelope::resized() {
   attackSlider.setBounds(area.removeFromLeft((int)half));
   releaseSlider.setBounds(area);
 }
-
-void MiniEnvelope::timerCallback() { repaint(); }
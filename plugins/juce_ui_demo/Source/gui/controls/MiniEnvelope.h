@@ -4,7 +4,8 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "GuiStyle.h"
 
-class MiniEnvelope : public juce::Component, private juce::Timer {
+// Repaints only when attack/release change; no timer.
+class MiniEnvelope : public juce::Component, private juce::Slider::Listener {
 public:
   MiniEnvelope(juce::AudioProcessorValueTreeState &vts,
                juce::RangedAudioParameter &attack,
@@ -14,7 +15,7 @@ public:
   void resized() override;
 
 private:
-  void timerCallback() override;
+  void sliderValueChanged(juce::Slider *) override { repaint(); }
   juce::AudioProcessorValueTreeState &processorState;
   juce::Slider attackSlider, releaseSlider;
   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
@@ -1,9 +1,6 @@
 #include "SimpleMeter.h"
 
-SimpleMeter::SimpleMeter(std::function<float()> rmsProvider)
-    : getRms(std::move(rmsProvider)) {
-  startTimerHz(30);
-}
+SimpleMeter::SimpleMeter(MeterChannel &source) : channel(source) {}
 
 void SimpleMeter::paint(juce::Graphics &g) {
   auto bounds = getLocalBounds().toFloat();
@@ -12,13 +9,38 @@ void SimpleMeter::paint(juce::Graphics &g) {
   g.setColour(guiBorder());
   g.drawRoundedRectangle(bounds, 6.0f, 1.0f);
 
-  auto bar = bounds.reduced(6.0f);
-  bar.removeFromLeft(bar.getWidth() * (1.0f - meterValue));
+  auto inner = bounds.reduced(6.0f);
+  auto bar = inner;
+  bar.removeFromLeft(bar.getWidth() * (1.0f - juce::jlimit(0.0f, 1.0f, reading.rms)));
   g.setColour(guiAccent());
   g.fillRoundedRectangle(bar, 4.0f);
+
+  const auto peakX = inner.getRight() - inner.getWidth() * juce::jlimit(0.0f, 1.0f, reading.peak);
+  g.setColour(juce::Colours::white.withAlpha(0.8f));
+  g.fillRect(juce::Rectangle<float>(peakX - 1.0f, inner.getY(), 2.0f, inner.getHeight()));
+
+  if (std::isfinite(reading.momentaryLufs)) {
+    g.setFont(juce::FontOptions(11.0f));
+    g.drawText(juce::String(reading.momentaryLufs, 1) + " LUFS",
+               inner.reduced(4.0f, 0.0f), juce::Justification::centredLeft);
+  }
+}
+
+SimpleMeter::Shown SimpleMeter::quantise(const MeterReading &r) const {
+  const auto width = (float)juce::jmax(0, getWidth() - 12);
+  Shown s;
+  s.barPx = juce::roundToInt(width * juce::jlimit(0.0f, 1.0f, r.rms));
+  s.peakPx = juce::roundToInt(width * juce::jlimit(0.0f, 1.0f, r.peak));
+  s.lufsTenths = std::isfinite(r.momentaryLufs) ? juce::roundToInt(r.momentaryLufs * 10.0f) : std::numeric_limits<int>::min();
+  return s;
 }
 
-void SimpleMeter::timerCallback() {
-  meterValue = juce::jlimit(0.0f, 1.0f, getRms());
-  repaint();
+void SimpleMeter::animationTick(double) {
+  if (!channel.read(reading))
+    return;
+  const auto next = quantise(reading);
+  if (next != shown) {
+    shown = next;
+    repaint();
+  }
 }
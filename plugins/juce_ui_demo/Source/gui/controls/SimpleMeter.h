@@ -1,15 +1,29 @@
 #pragma once
 
 #include <juce_gui_extra/juce_gui_extra.h>
+#include "AnimationScheduler.h"
 #include "GuiStyle.h"
+#include "MeterReading.h"
 
-class SimpleMeter : public juce::Component, private juce::Timer {
+/** RMS bar with a peak marker and momentary LUFS readout. Reads the
+    processor's MeterChannel (it must be the channel's only reader). */
+class SimpleMeter : public juce::Component, public AnimationScheduler::Client {
 public:
-  explicit SimpleMeter(std::function<float()> rmsProvider);
+  explicit SimpleMeter(MeterChannel &source);
   void paint(juce::Graphics &g) override;
+  void animationTick(double deltaSec) override;
 
 private:
-  void timerCallback() override;
-  std::function<float()> getRms;
-  float meterValue = 0.0f;
+  // Quantised to what paint() can show, so unchanged frames skip repaint().
+  struct Shown {
+    int barPx = -1, peakPx = -1, lufsTenths = 0;
+    bool operator!=(const Shown &o) const {
+      return barPx != o.barPx || peakPx != o.peakPx || lufsTenths != o.lufsTenths;
+    }
+  };
+  Shown quantise(const MeterReading &r) const;
+
+  MeterChannel &channel;
+  MeterReading reading;
+  Shown shown;
 };
@@ -19,6 +19,10 @@ StepSequencerView::StepSequencerView(
 }
 
 void StepSequencerView::paint(juce::Graphics &g) {
+  chrome.draw(g, getLocalBounds(), [this](juce::Graphics &cg) { paintChrome(cg); });
+}
+
+void StepSequencerView::paintChrome(juce::Graphics &g) const {
   g.fillAll(guiPanel());
   auto bounds = getLocalBounds().toFloat();
   g.setColour(guiBorder());
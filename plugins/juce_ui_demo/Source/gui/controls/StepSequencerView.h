@@ -3,6 +3,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "GuiStyle.h"
+#include "LayerCache.h"
 
 class StepSequencerView : public juce::Component {
 public:
@@ -18,5 +19,8 @@ private:
         attach;
   };
 
+  void paintChrome(juce::Graphics &g) const;
+
+  LayerCache chrome; // everything here is static; the bars are child sliders
   std::vector<StepWidget> steps;
 };
@@ -1,6 +1,8 @@
 // MAStyle token palette stub for C++/JUCE or other consumers.
 // Generated from the Swift tokens; values here are placeholders—replace with actual
 // exported JSON (e.g., from scripts/export_tokens.swift) or parse /tmp/ma_theme.json.
+// The JUCE plugins use the constexpr <ma/tokens/MaTokens.h> generated from
+// ma_tokens.json by plugins/common/cmake/GenerateDesignTokens.cmake instead.
 
 #pragma once
 
@@ -1,18 +1,39 @@
 #!/usr/bin/env swift
 import Foundation
 import MAStyle
+import SwiftUI
+#if canImport(AppKit)
+import AppKit
+#endif
+
+// "#RRGGBB" for opaque colours, "rgba(r,g,b,a)" otherwise; the formats
+// plugins/common/cmake/GenerateDesignTokens.cmake accepts.
+func tokenString(_ color: Color) -> String {
+    #if canImport(AppKit)
+    if let c = NSColor(color).usingColorSpace(.sRGB) {
+        let r = Int((c.redComponent * 255).rounded())
+        let g = Int((c.greenComponent * 255).rounded())
+        let b = Int((c.blueComponent * 255).rounded())
+        if c.alphaComponent >= 1.0 {
+            return String(format: "#%02X%02X%02X", r, g, b)
+        }
+        return String(format: "rgba(%d,%d,%d,%.2f)", r, g, b, Double(c.alphaComponent))
+    }
+    #endif
+    return color.description
+}
 
 let colors: [String: Any] = [
-    "background": MAStyle.ColorToken.background.description,
-    "panel": MAStyle.ColorToken.panel.description,
-    "border": MAStyle.ColorToken.border.description,
-    "primary": MAStyle.ColorToken.primary.description,
-    "success": MAStyle.ColorToken.success.description,
-    "warning": MAStyle.ColorToken.warning.description,
-    "danger": MAStyle.ColorToken.danger.description,
-    "info": MAStyle.ColorToken.info.description,
-    "muted": MAStyle.ColorToken.muted.description,
-    "metricBG": MAStyle.ColorToken.metricBG.description
+    "background": tokenString(MAStyle.ColorToken.background),
+    "panel": tokenString(MAStyle.ColorToken.panel),
+    "border": tokenString(MAStyle.ColorToken.border),
+    "primary": tokenString(MAStyle.ColorToken.primary),
+    "success": tokenString(MAStyle.ColorToken.success),
+    "warning": tokenString(MAStyle.ColorToken.warning),
+    "danger": tokenString(MAStyle.ColorToken.danger),
+    "info": tokenString(MAStyle.ColorToken.info),
+    "muted": tokenString(MAStyle.ColorToken.muted),
+    "metricBG": tokenString(MAStyle.ColorToken.metricBG)
 ]
 
 let spacing: [String: Any] = [
@@ -37,7 +58,7 @@ let theme: [String: Any] = [
     "radius": radius
 ]
 
-let data = try JSONSerialization.data(withJSONObject: theme, options: [.prettyPrinted])
+let data = try JSONSerialization.data(withJSONObject: theme, options: [.prettyPrinted, .sortedKeys])
 if let json = String(data: data, encoding: .utf8) {
     print(json)
 }
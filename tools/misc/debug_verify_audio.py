@@ -3,6 +3,7 @@ from engines.audio_engine.tools.misc.debug_verify_audio import (
     lufs_r128,
     main,
     peak_dbfs,
+    probe_features,
     read_audio,
     sha1,
     to_mono,
@@ -12,6 +13,7 @@ __all__ = [
     "lufs_r128",
     "main",
     "peak_dbfs",
+    "probe_features",
     "read_audio",
     "sha1",
     "to_mono",